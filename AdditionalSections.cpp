@@ -0,0 +1,251 @@
+﻿#include "AdditionalSections.h"
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+
+#include "FieldParser.h"
+
+namespace {
+
+/**
+ * @brief Returns the `n`-th comma-separated component of a raw section, or an empty view.
+ */
+std::string_view component(std::string_view raw, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        const size_t comma = raw.find(',');
+        if (comma == std::string_view::npos) {
+            return {};
+        }
+        raw.remove_prefix(comma + 1);
+    }
+    return raw.substr(0, raw.find(','));
+}
+
+/**
+ * @brief Appends a fixed-point component divided by its scaling factor unless it is missing or
+ *        malformed.
+ */
+void appendScaled(std::string_view part, int32_t missing, double scale, std::vector<double>& values) {
+    int32_t value = 0;
+    if (FieldParser::parseInt(part, value) == ParseResult::Ok && value != missing) {
+        values.push_back(value / scale);
+    }
+}
+
+void appendText(std::string_view raw, std::string& text) {
+    if (!text.empty()) {
+        text += ';';
+    }
+    text += raw;
+}
+
+std::string joinText(const std::vector<std::string>& values) {
+    std::string text;
+    for (const std::string& value : values) {
+        appendText(value, text);
+    }
+    return text;
+}
+
+std::string joinNumbers(const std::vector<double>& values) {
+    std::string text;
+    char buffer[32];
+    for (const double value : values) {
+        if (!text.empty()) {
+            text += ',';
+        }
+        const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        text.append(buffer, end);
+    }
+    return text;
+}
+
+std::string_view family(std::string_view code) {
+    while (!code.empty() && code.back() >= '0' && code.back() <= '9') {
+        code.remove_suffix(1);
+    }
+    return code;
+}
+
+}
+
+/**
+ * @brief Returns every section family that can be decoded, with the column it fills.
+ *
+ * Lists of numbers are stored comma-separated; lists of raw sections, whose values contain
+ * commas themselves, are stored semicolon-separated.
+ *
+ * @return The registry of section decoders.
+ */
+const std::vector<SectionDecoder>& AdditionalSections::decoders() {
+    static const std::vector<SectionDecoder> registry = {
+        // AA1-AA4: liquid precipitation, depth in mm
+        {"AA", "hourlyPrecipitation",
+         [](std::string_view raw, Measurement& m) { appendScaled(component(raw, 1), 9999, 10, m.hourlyPrecipitation); },
+         [](const Measurement& m) { return joinNumbers(m.hourlyPrecipitation); }},
+        // AJ1: snow depth
+        {"AJ", "groundConditionsOrSnowDepth",
+         [](std::string_view raw, Measurement& m) { appendText(raw, m.groundConditionsOrSnowDepth); },
+         [](const Measurement& m) { return m.groundConditionsOrSnowDepth; }},
+        // AU1-AU9: present weather
+        {"AU", "weatherPhenomena",
+         [](std::string_view raw, Measurement& m) { appendText(raw, m.weatherPhenomena); },
+         [](const Measurement& m) { return m.weatherPhenomena; }},
+        // GA1-GA6: sky cover layers
+        {"GA", "skyCover",
+         [](std::string_view raw, Measurement& m) { m.skyCover.emplace_back(raw); },
+         [](const Measurement& m) { return joinText(m.skyCover); }},
+        // KA1-KA4: extreme air temperatures
+        {"KA", "temperatureExtremes",
+         [](std::string_view raw, Measurement& m) { m.temperatureExtremes.emplace_back(raw); },
+         [](const Measurement& m) { return joinText(m.temperatureExtremes); }},
+        // KB1-KB3: average air temperatures in degrees Celsius, stored in hundredths
+        {"KB", "temperatureObservations",
+         [](std::string_view raw, Measurement& m) { appendScaled(component(raw, 2), 9999, 100, m.temperatureObservations); },
+         [](const Measurement& m) { return joinNumbers(m.temperatureObservations); }},
+        // MA1: altimeter setting and station pressure
+        {"MA", "atmosphericParameters",
+         [](std::string_view raw, Measurement& m) { m.atmosphericParameters.emplace_back(raw); },
+         [](const Measurement& m) { return joinText(m.atmosphericParameters); }},
+        // MD1: atmospheric pressure change
+        {"MD", "atmosphericPressureTendency",
+         [](std::string_view raw, Measurement& m) { appendText(raw, m.atmosphericPressureTendency); },
+         [](const Measurement& m) { return m.atmosphericPressureTendency; }},
+        // OC1: wind gust
+        {"OC", "extremeWindConditions",
+         [](std::string_view raw, Measurement& m) { m.extremeWindConditions.emplace_back(raw); },
+         [](const Measurement& m) { return joinText(m.extremeWindConditions); }},
+        // REM: remarks
+        {"REM", "remarksOrAdditionalNotes",
+         [](std::string_view raw, Measurement& m) { appendText(raw, m.remarksOrAdditionalNotes); },
+         [](const Measurement& m) { return m.remarksOrAdditionalNotes; }},
+        // EQD: element quality data
+        {"EQD", "equipmentDiagnosticsMetadata",
+         [](std::string_view raw, Measurement& m) { appendText(raw, m.equipmentDiagnosticsMetadata); },
+         [](const Measurement& m) { return m.equipmentDiagnosticsMetadata; }},
+    };
+    return registry;
+}
+
+/**
+ * @brief Resolves the section families a user enabled, e.g. {"AA1-AA4", "GA"} or {"all"}.
+ *
+ * Each code is reduced to its family by dropping everything from the first digit or dash, so
+ * "AA1-AA4", "AA1" and "AA" all enable the AA decoder. Unknown families are reported on
+ * standard error and skipped.
+ *
+ * @param codes The section codes or families to enable.
+ * @return The decoders to run, without duplicates.
+ */
+std::vector<const SectionDecoder*> AdditionalSections::select(const std::vector<std::string>& codes) {
+    std::vector<const SectionDecoder*> enabled;
+
+    for (const std::string& code : codes) {
+        if (code == "all") {
+            enabled.clear();
+            for (const SectionDecoder& decoder : decoders()) {
+                enabled.push_back(&decoder);
+            }
+            return enabled;
+        }
+
+        const std::string_view name = std::string_view(code).substr(0, code.find_first_of("0123456789-"));
+        const SectionDecoder* match = nullptr;
+        for (const SectionDecoder& decoder : decoders()) {
+            if (decoder.prefix == name) {
+                match = &decoder;
+            }
+        }
+
+        if (match == nullptr) {
+            std::cerr << "Warning: Unknown section '" << code << "' ignored." << std::endl;
+        } else if (std::find(enabled.begin(), enabled.end(), match) == enabled.end()) {
+            enabled.push_back(match);
+        }
+    }
+
+    return enabled;
+}
+
+/**
+ * @brief Keeps the raw additional-data sections of a row and decodes the enabled ones.
+ *
+ * Non-empty sections are appended to `raw` as "code\traw" pairs, separated by tabs. Sections
+ * whose family has a decoder in the plan are decoded straight from the field views as well.
+ *
+ * @param fields The tokenized data line.
+ * @param columns The additional-data columns of the file's `ColumnPlan`.
+ * @param raw Receives the pairs after its current contents, e.g. a batch's text buffer.
+ * @param measurement Receives the decoded members.
+ * @param used Receives each decoder that ran and was not listed yet.
+ */
+void AdditionalSections::capture(const std::vector<std::string_view>& fields, const std::vector<SectionColumn>& columns, std::pmr::string& raw, Measurement& measurement, std::vector<const SectionDecoder*>& used) {
+    const size_t start = raw.size();
+
+    for (const SectionColumn& column : columns) {
+        if (column.index >= fields.size()) {
+            break;
+        }
+
+        const std::string_view value = fields[column.index];
+        if (value.empty()) {
+            continue;
+        }
+
+        if (raw.size() > start) {
+            raw += '\t';
+        }
+        raw += column.code;
+        raw += '\t';
+        raw += value;
+
+        if (column.decoder != nullptr) {
+            column.decoder->decode(value, measurement);
+            if (std::find(used.begin(), used.end(), column.decoder) == used.end()) {
+                used.push_back(column.decoder);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Decodes the enabled families from previously captured raw sections.
+ *
+ * This is the deferred counterpart of `capture`, used when reading measurements back and by
+ * the `backfill` command.
+ *
+ * @param raw The stored "code\traw" pairs of a measurement.
+ * @param enabled The decoders to run.
+ * @param measurement The measurement receiving the decoded members.
+ */
+void AdditionalSections::decode(std::string_view raw, const std::vector<const SectionDecoder*>& enabled, Measurement& measurement) {
+    while (!raw.empty()) {
+        const size_t codeEnd = raw.find('\t');
+        if (codeEnd == std::string_view::npos) {
+            return;
+        }
+        const std::string_view code = raw.substr(0, codeEnd);
+        raw.remove_prefix(codeEnd + 1);
+
+        const size_t valueEnd = raw.find('\t');
+        const std::string_view value = raw.substr(0, valueEnd);
+        raw.remove_prefix(valueEnd == std::string_view::npos ? raw.size() : valueEnd + 1);
+
+        if (const SectionDecoder* decoder = decoderFor(code, enabled)) {
+            decoder->decode(value, measurement);
+        }
+    }
+}
+
+/**
+ * @brief Finds the enabled decoder for a section code such as "GA3", if any.
+ */
+const SectionDecoder* AdditionalSections::decoderFor(std::string_view code, const std::vector<const SectionDecoder*>& enabled) {
+    const std::string_view name = family(code);
+    for (const SectionDecoder* decoder : enabled) {
+        if (decoder->prefix == name) {
+            return decoder;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,59 @@
+﻿#ifndef ADDITIONALSECTIONS_H
+#define ADDITIONALSECTIONS_H
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Measurement.h"
+
+/**
+ * @struct SectionDecoder
+ * @brief Decodes one family of ISD additional-data sections into a `Measurement` member.
+ *
+ * `prefix` is the section family, e.g. "AA" for AA1 to AA4. `decode` is called once per
+ * non-empty section of that family and appends to the member, `serialize` renders the member
+ * for the database column named `column`.
+ */
+struct SectionDecoder {
+    const char* prefix;
+    const char* column;
+    void (*decode)(std::string_view raw, Measurement& measurement);
+    std::string (*serialize)(const Measurement& measurement);
+};
+
+/**
+ * @struct SectionColumn
+ * @brief An additional-data column of a CSV file, resolved once from its header by `ColumnPlan`.
+ *
+ * `decoder` is null when the section is not enabled for decoding; its raw value is still kept.
+ */
+struct SectionColumn {
+    size_t index;
+    std::string code;
+    const SectionDecoder* decoder;
+};
+
+/**
+ * @class AdditionalSections
+ * @brief Keeps the raw ISD additional-data sections of a measurement and decodes them on demand.
+ *
+ * The optional sections (AA1, GA1, KA1, REM, ...) vary per file and are rarely all needed. At
+ * ingest every non-empty section is kept verbatim as tab-separated code and value pairs, the
+ * format of `Measurement::additionalSections`, and only the families the user enabled are
+ * decoded into their `Measurement` members. `capture` writes that format and `decode` reads
+ * it. The raw text is stored in the database too, so further families
+ * can be decoded later with the `backfill` command without reloading the source files.
+ */
+class AdditionalSections {
+public:
+    static const std::vector<SectionDecoder>& decoders();
+    static std::vector<const SectionDecoder*> select(const std::vector<std::string>& codes);
+    static const SectionDecoder* decoderFor(std::string_view code, const std::vector<const SectionDecoder*>& enabled);
+    static void capture(const std::vector<std::string_view>& fields, const std::vector<SectionColumn>& columns, std::pmr::string& raw, Measurement& measurement, std::vector<const SectionDecoder*>& used);
+    static void decode(std::string_view raw, const std::vector<const SectionDecoder*>& enabled, Measurement& measurement);
+};
+
+
+
+#endif //ADDITIONALSECTIONS_H
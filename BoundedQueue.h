@@ -0,0 +1,86 @@
+﻿#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/**
+ * @class BoundedQueue
+ * @brief Blocking multi-producer, multi-consumer FIFO queue with a fixed capacity.
+ *
+ * Connects the stages of the ingest pipeline. Producers block in `push` while the queue is
+ * full, so a fast stage cannot run arbitrarily far ahead of a slow one and memory stays
+ * bounded. Consumers block in `pop` until an item arrives or the queue is closed.
+ *
+ * Closing the queue wakes every waiting thread: `push` then refuses new items and `pop` drains
+ * the remaining ones before returning an empty optional.
+ *
+ * @tparam T The item type; must be movable.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity == 0 ? 1 : capacity) {
+    }
+
+    /**
+     * @brief Appends an item, waiting while the queue is full.
+     *
+     * @param item The item to append.
+     * @return True if the item was queued, false if the queue was closed.
+     */
+    bool push(T item) {
+        std::unique_lock lock(this->mutex);
+        this->notFull.wait(lock, [this] { return this->closed || this->items.size() < this->capacity; });
+        if (this->closed) {
+            return false;
+        }
+        this->items.push_back(std::move(item));
+        lock.unlock();
+        this->notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest item, waiting while the queue is empty and still open.
+     *
+     * @return The item, or an empty optional once the queue is closed and drained.
+     */
+    std::optional<T> pop() {
+        std::unique_lock lock(this->mutex);
+        this->notEmpty.wait(lock, [this] { return this->closed || !this->items.empty(); });
+        if (this->items.empty()) {
+            return std::nullopt;
+        }
+        T item = std::move(this->items.front());
+        this->items.pop_front();
+        lock.unlock();
+        this->notFull.notify_one();
+        return item;
+    }
+
+    /**
+     * @brief Closes the queue; producers stop, consumers drain what is left.
+     */
+    void close() {
+        {
+            std::lock_guard lock(this->mutex);
+            this->closed = true;
+        }
+        this->notFull.notify_all();
+        this->notEmpty.notify_all();
+    }
+private:
+    const size_t capacity;
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    std::deque<T> items;
+    bool closed = false;
+};
+
+
+
+#endif //BOUNDEDQUEUE_H
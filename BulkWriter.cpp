@@ -0,0 +1,134 @@
+﻿#include "BulkWriter.h"
+
+/**
+ * @brief Prepares the statements of a writer; no transaction is opened yet.
+ *
+ * @param db The handler to write through. Its tables must exist.
+ * @param commitRows The number of rows after which a transaction is committed; 0 commits only
+ *                   on `commit`.
+ */
+BulkWriter::BulkWriter(SQLiteHandler& db, size_t commitRows)
+    : db(db),
+      commitRows(commitRows),
+      measurementInsert(db.db, SQLiteHandler::insertMeasurementSql()),
+      stationInsert(db.db, SQLiteHandler::insertStationSql()) {
+}
+
+/**
+ * @brief Rolls back a transaction that was not committed.
+ */
+BulkWriter::~BulkWriter() {
+    rollback();
+}
+
+/**
+ * @brief Writes the rows of a batch, committing whenever `commitRows` rows are pending.
+ *
+ * The dictionary codes assigned since the last write are stored in the transaction of the
+ * batch's first row, before any row that uses them.
+ *
+ * @param measurements The batch of parsed rows to insert.
+ */
+void BulkWriter::write(const MeasurementBatch& measurements) {
+    try {
+        size_t next = 0;
+        for (size_t row = 0; row < measurements.size(); ++row) {
+            begin();
+            if (row == 0) {
+                this->db.storeDictionaries();
+            }
+            this->db.insertRow(this->measurementInsert, measurements, row, next);
+            written();
+        }
+    } catch (...) {
+        rollback();
+        throw;
+    }
+}
+
+/**
+ * @brief Writes station records, committing whenever `commitRows` rows are pending.
+ *
+ * @param stations The stations to insert.
+ */
+void BulkWriter::write(const std::vector<Station>& stations) {
+    try {
+        for (const Station& station : stations) {
+            begin();
+            this->db.insertRow(this->stationInsert, station);
+            written();
+        }
+    } catch (...) {
+        rollback();
+        throw;
+    }
+}
+
+/**
+ * @brief Commits the open transaction, if any; the next row starts a new one.
+ *
+ * A failed commit is rolled back and rethrown.
+ */
+void BulkWriter::commit() {
+    if (!this->open) {
+        return;
+    }
+
+    try {
+        this->db.commitTransaction();
+    } catch (...) {
+        rollback();
+        throw;
+    }
+    this->open = false;
+    this->pendingRows = 0;
+}
+
+/**
+ * @brief Discards the open transaction, if any.
+ *
+ * Never throws, as it runs while an error is handled. The dictionary codes are stored again
+ * with the next rows, even if the rollback itself fails.
+ */
+void BulkWriter::rollback() {
+    if (!this->open) {
+        return;
+    }
+
+    this->open = false;
+    this->pendingRows = 0;
+    // A statement whose step failed reports that error again on reset
+    this->measurementInsert.tryReset();
+    this->stationInsert.tryReset();
+    try {
+        this->db.rollbackTransaction();
+    } catch (...) {
+    }
+}
+
+/**
+ * @brief Returns the number of rows written in the open transaction.
+ */
+size_t BulkWriter::pending() const {
+    return this->pendingRows;
+}
+
+/**
+ * @brief Opens a transaction unless one is open already.
+ */
+void BulkWriter::begin() {
+    if (!this->open) {
+        this->db.beginTransaction();
+        this->open = true;
+    }
+}
+
+/**
+ * @brief Counts a written row and commits once `commitRows` rows are pending.
+ */
+void BulkWriter::written() {
+    this->pendingRows++;
+    if (this->commitRows > 0 && this->pendingRows >= this->commitRows) {
+        commit();
+    }
+}
@@ -0,0 +1,58 @@
+﻿#ifndef BULKWRITER_H
+#define BULKWRITER_H
+#include <cstddef>
+#include <vector>
+
+#include "MeasurementBatch.h"
+#include "SQLiteHandler.h"
+#include "Station.h"
+#include "SQLiteCpp/Statement.h"
+
+/**
+ * @class BulkWriter
+ * @brief Writes measurements and stations in explicit transactions of a configurable size.
+ *
+ * SQLite commits, and syncs to disk, every statement that runs outside a transaction. The
+ * writer opens a transaction with the first row it is given and commits it as soon as
+ * `commitRows` rows have been written, starting the next one with the following row; with
+ * `commitRows` 0 a transaction lasts until `commit` is called. The INSERT statements are
+ * prepared once, when the writer is created, and reused for every row of every transaction;
+ * row ids come from the handler's generator without a lookup per row.
+ *
+ * Other statements run on the same `SQLiteHandler` while a transaction is open, such as a
+ * manifest update, become part of it, so a file's last rows and its manifest entry are
+ * committed together by `commit`.
+ *
+ * If writing a row fails, the open transaction is rolled back before the error is rethrown,
+ * and the database holds exactly the transactions committed before. A writer destroyed with a
+ * transaction still open rolls it back as well, so `commit` must follow the last row.
+ *
+ * The writer is not thread-safe, and the handler must not start transactions of its own while
+ * the writer is used.
+ */
+class BulkWriter {
+public:
+    BulkWriter(SQLiteHandler& db, size_t commitRows);
+    BulkWriter(const BulkWriter&) = delete;
+    BulkWriter& operator=(const BulkWriter&) = delete;
+    ~BulkWriter();
+    void write(const MeasurementBatch& measurements);
+    void write(const std::vector<Station>& stations);
+    void commit();
+    void rollback();
+    size_t pending() const;
+private:
+    SQLiteHandler& db;
+    size_t commitRows;
+    size_t pendingRows = 0;
+    bool open = false;
+    SQLite::Statement measurementInsert;
+    SQLite::Statement stationInsert;
+
+    void begin();
+    void written();
+};
+
+
+
+#endif //BULKWRITER_H
@@ -0,0 +1,99 @@
+﻿#include "CodeDictionary.h"
+#include <algorithm>
+#include <mutex>
+
+/**
+ * @brief Returns the code of a value, assigning the next free code to a value not seen before.
+ *
+ * @param value The field value; the empty value has the code 0.
+ * @return The value's code.
+ */
+int32_t CodeDictionary::encode(std::string_view value) {
+    if (value.empty()) {
+        return 0;
+    }
+
+    {
+        std::shared_lock lock(this->mutex);
+        const auto found = this->codes.find(value);
+        if (found != this->codes.end()) {
+            return found->second;
+        }
+    }
+
+    std::unique_lock lock(this->mutex);
+    const auto [entry, inserted] = this->codes.try_emplace(std::string(value), this->next);
+    if (inserted) {
+        this->added.emplace_back(this->next, entry->first);
+        this->next++;
+    }
+    return entry->second;
+}
+
+/**
+ * @brief Returns the code of a value, answering a repeat of the previous value without a lookup.
+ *
+ * @param value The field value.
+ * @param last The previous value of the column and its code; updated when the value changes.
+ * @return The value's code.
+ */
+int32_t CodeDictionary::encode(std::string_view value, LastCode& last) {
+    if (value == last.value) {
+        return last.code;
+    }
+    last.code = encode(value);
+    last.value = value;
+    return last.code;
+}
+
+/**
+ * @brief Registers a code already stored in the database, e.g. when a load appends to it.
+ *
+ * Registered codes are not returned by `takeAdded`.
+ */
+void CodeDictionary::add(int32_t code, std::string_view value) {
+    std::unique_lock lock(this->mutex);
+    this->codes.insert_or_assign(std::string(value), code);
+    this->next = std::max(this->next, code + 1);
+}
+
+/**
+ * @brief Hands over the codes assigned since the last call, in the order they were assigned.
+ */
+std::vector<std::pair<int32_t, std::string>> CodeDictionary::takeAdded() {
+    std::unique_lock lock(this->mutex);
+    return std::exchange(this->added, {});
+}
+
+/**
+ * @brief Hands every known value to the next `takeAdded` again, in the order of the codes.
+ *
+ * Used after a rollback, which may have discarded codes that were already taken.
+ */
+void CodeDictionary::restoreAdded() {
+    std::unique_lock lock(this->mutex);
+    this->added.clear();
+    this->added.reserve(this->codes.size());
+    for (const auto& [value, code] : this->codes) {
+        this->added.emplace_back(code, value);
+    }
+    std::sort(this->added.begin(), this->added.end());
+}
+
+/**
+ * @brief Returns the number of known values, not counting the empty one.
+ */
+size_t CodeDictionary::size() const {
+    std::shared_lock lock(this->mutex);
+    return this->codes.size();
+}
+
+/**
+ * @brief Forgets every code, e.g. after the dictionary table has been dropped.
+ */
+void CodeDictionary::clear() {
+    std::unique_lock lock(this->mutex);
+    this->codes.clear();
+    this->added.clear();
+    this->next = 1;
+}
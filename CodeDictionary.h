@@ -0,0 +1,65 @@
+﻿#ifndef CODEDICTIONARY_H
+#define CODEDICTIONARY_H
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @class CodeDictionary
+ * @brief Thread-safe map from the values of a low-cardinality text field to small integer codes.
+ *
+ * Fields such as the report type take only a few dozen distinct values, so measurements store
+ * a code into a dictionary table instead of the text. Codes start at 1 and are never reused;
+ * the empty value always has the code 0 and is stored as NULL. Lookups of known values only
+ * take a shared lock, and a `LastCode` remembers the previous value of a column, so a run of
+ * equal values, as every file has, does not lock at all.
+ *
+ * Codes assigned during a load are collected until `takeAdded` hands them to the writer, which
+ * stores them in the same transaction as the rows that use them.
+ */
+class CodeDictionary {
+public:
+    struct LastCode {
+        std::string value;
+        int32_t code = 0;
+    };
+
+    int32_t encode(std::string_view value);
+    int32_t encode(std::string_view value, LastCode& last);
+    void add(int32_t code, std::string_view value);
+    std::vector<std::pair<int32_t, std::string>> takeAdded();
+    void restoreAdded();
+    size_t size() const;
+    void clear();
+private:
+    struct Hash {
+        using is_transparent = void;
+        size_t operator()(std::string_view value) const {
+            return std::hash<std::string_view>{}(value);
+        }
+    };
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, int32_t, Hash, std::equal_to<>> codes;
+    std::vector<std::pair<int32_t, std::string>> added;
+    int32_t next = 1;
+};
+
+/**
+ * @struct MeasurementDictionaries
+ * @brief The dictionaries of the categorical measurement fields, one per dictionary table.
+ */
+struct MeasurementDictionaries {
+    CodeDictionary reportType;
+    CodeDictionary qualityControlFlag;
+    CodeDictionary source;
+};
+
+
+
+#endif //CODEDICTIONARY_H
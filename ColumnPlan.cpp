@@ -0,0 +1,96 @@
+﻿#include "ColumnPlan.h"
+#include <algorithm>
+
+#include "CsvTokenizer.h"
+
+namespace {
+
+// Header names, in the order of `CsvColumn`
+constexpr std::string_view columnNames[] = {
+    "STATION",
+    "DATE",
+    "SOURCE",
+    "LATITUDE",
+    "LONGITUDE",
+    "ELEVATION",
+    "NAME",
+    "REPORT_TYPE",
+    "CALL_SIGN",
+    "QUALITY_CONTROL",
+    "WND",
+    "CIG",
+    "VIS",
+    "TMP",
+    "DEW",
+    "SLP",
+};
+
+static_assert(std::size(columnNames) == static_cast<size_t>(CsvColumn::Count));
+
+constexpr std::string_view byteOrderMark = "\xEF\xBB\xBF";
+
+std::string_view withoutByteOrderMark(std::string_view text) {
+    if (text.starts_with(byteOrderMark)) {
+        text.remove_prefix(byteOrderMark.size());
+    }
+    return text;
+}
+
+}
+
+/**
+ * @brief Creates the plan of NOAA's standard layout, without additional sections.
+ */
+ColumnPlan::ColumnPlan() : width(static_cast<size_t>(CsvColumn::Count)) {
+    for (size_t column = 0; column < this->columns.size(); ++column) {
+        this->columns[column] = column;
+    }
+}
+
+/**
+ * @brief Checks whether a line is a header line rather than data.
+ *
+ * Only the start of the line is looked at, and the loader only asks for the first line of a
+ * file, so data lines are never searched.
+ */
+bool ColumnPlan::isHeader(std::string_view line) {
+    line = withoutByteOrderMark(line);
+    return line.starts_with("\"STATION\"") || line.starts_with("STATION");
+}
+
+/**
+ * @brief Resolves the columns of a file from its header line.
+ *
+ * This runs once per file, so the per-row work is a plain index into the fields without any
+ * lookups by name. Every column that is not one of the `CsvColumn`s is an additional-data
+ * section; the enabled decoders are matched to them here as well.
+ *
+ * @param header The header line of the file, possibly starting with a UTF-8 byte order mark.
+ * @param enabled The decoders selected for this load.
+ * @return The plan of the file.
+ */
+ColumnPlan ColumnPlan::fromHeader(std::string_view header, const std::vector<const SectionDecoder*>& enabled) {
+    ColumnPlan plan;
+    plan.columns.fill(absent);
+    plan.width = 0;
+
+    std::vector<std::string_view> names;
+    CsvTokenizer::tokenize(withoutByteOrderMark(header), names);
+
+    for (size_t index = 0; index < names.size(); ++index) {
+        const std::string_view name = names[index];
+        const auto known = std::find(std::begin(columnNames), std::end(columnNames), name);
+        if (known == std::end(columnNames)) {
+            plan.sections.push_back({index, std::string(name), AdditionalSections::decoderFor(name, enabled)});
+            continue;
+        }
+
+        size_t& column = plan.columns[known - std::begin(columnNames)];
+        if (column == absent) {
+            column = index;
+            plan.width = std::max(plan.width, index + 1);
+        }
+    }
+
+    return plan;
+}
@@ -0,0 +1,76 @@
+﻿#ifndef COLUMNPLAN_H
+#define COLUMNPLAN_H
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "AdditionalSections.h"
+
+/**
+ * @enum CsvColumn
+ * @brief The columns of a NOAA global-hourly CSV file the loader reads by name.
+ *
+ * Declared in the order of NOAA's standard layout, so a column's value is also its position in
+ * a file that has exactly that layout.
+ */
+enum class CsvColumn : size_t {
+    Station,
+    Date,
+    Source,
+    Latitude,
+    Longitude,
+    Elevation,
+    Name,
+    ReportType,
+    CallSign,
+    QualityControl,
+    Wind,
+    CloudCeiling,
+    Visibility,
+    Temperature,
+    DewPoints,
+    SeaLevelPressure,
+    Count,
+};
+
+/**
+ * @class ColumnPlan
+ * @brief Where each needed field of a CSV file is, resolved once from the file's header.
+ *
+ * NOAA files do not all have the same columns: the additional-data sections vary per station,
+ * and a mandatory column may be missing altogether. Instead of fixed positions, every field is
+ * read through the plan, which maps it to its index in the header. A column missing from the
+ * header reads as an empty field. `width` is the number of fields a data line needs to reach
+ * every mandatory column the file has; shorter lines are rejected. `sections` lists the
+ * remaining columns, the additional-data sections.
+ *
+ * A default-constructed plan has NOAA's standard layout and no additional sections, for input
+ * without a header line.
+ */
+class ColumnPlan {
+public:
+    static constexpr size_t absent = std::numeric_limits<size_t>::max();
+
+    std::array<size_t, static_cast<size_t>(CsvColumn::Count)> columns;
+    size_t width;
+    std::vector<SectionColumn> sections;
+
+    ColumnPlan();
+    static bool isHeader(std::string_view line);
+    static ColumnPlan fromHeader(std::string_view header, const std::vector<const SectionDecoder*>& enabled);
+
+    /**
+     * @brief Returns the field of a column in a tokenized data line, or an empty view if the
+     *        file or the line does not have it.
+     */
+    std::string_view field(const std::vector<std::string_view>& fields, CsvColumn column) const {
+        const size_t index = this->columns[static_cast<size_t>(column)];
+        return index < fields.size() ? fields[index] : std::string_view();
+    }
+};
+
+
+
+#endif //COLUMNPLAN_H
@@ -0,0 +1,154 @@
+﻿#include "CsvScanner.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CSVSCANNER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CSVSCANNER_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CSVSCANNER_TARGET(isa)
+#endif
+
+namespace {
+
+using ScanFunction = CsvMasks (*)(const char*);
+
+struct ScanImplementation {
+    ScanFunction scan;
+    const char* name;
+};
+
+#ifdef CSVSCANNER_X86
+/**
+ * @brief Classifies a 64-byte block using four 16-byte SSE2 compares per character class.
+ */
+CSVSCANNER_TARGET("sse2")
+CsvMasks scanSse2(const char* block) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i comma = _mm_set1_epi8(',');
+    CsvMasks masks = {0, 0};
+
+    for (int i = 0; i < 4; ++i) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+        const auto quotes = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)));
+        const auto commas = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, comma)));
+        masks.quotes |= static_cast<uint64_t>(quotes) << (i * 16);
+        masks.commas |= static_cast<uint64_t>(commas) << (i * 16);
+    }
+
+    return masks;
+}
+
+/**
+ * @brief Classifies a 64-byte block using two 32-byte AVX2 compares per character class.
+ */
+CSVSCANNER_TARGET("avx2")
+CsvMasks scanAvx2(const char* block) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+
+    const auto quotesLo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, quote)));
+    const auto quotesHi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, quote)));
+    const auto commasLo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, comma)));
+    const auto commasHi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, comma)));
+
+    return {
+        quotesLo | static_cast<uint64_t>(quotesHi) << 32,
+        commasLo | static_cast<uint64_t>(commasHi) << 32,
+    };
+}
+
+/**
+ * @brief Checks whether the CPU and the operating system both support AVX2.
+ */
+bool hasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // AVX needs OSXSAVE and the OS saving the YMM registers on context switches
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+/**
+ * @brief Picks the widest scanner supported by the CPU running the program.
+ */
+ScanImplementation selectImplementation() {
+#ifdef CSVSCANNER_X86
+    if (hasAvx2()) {
+        return {scanAvx2, "avx2"};
+    }
+    return {scanSse2, "sse2"};
+#else
+    return {CsvScanner::scanScalar, "scalar"};
+#endif
+}
+
+const ScanImplementation& implementation() {
+    static const ScanImplementation selected = selectImplementation();
+    return selected;
+}
+
+}
+
+/**
+ * @brief Classifies a 64-byte block of CSV input with the implementation selected for this CPU.
+ *
+ * The implementation is detected on the first call and reused afterwards. The block must be
+ * readable for `CsvScanner::blockSize` bytes; callers pad the tail of a line themselves.
+ *
+ * @param block Pointer to 64 readable bytes of input.
+ * @return The quote and comma masks of the block.
+ */
+CsvMasks CsvScanner::scan(const char* block) {
+    return implementation().scan(block);
+}
+
+/**
+ * @brief Classifies a 64-byte block one byte at a time.
+ *
+ * This is the portable fallback and the reference the vector implementations must match.
+ * The loop has no data-dependent branches; each comparison result is shifted straight into
+ * its mask.
+ *
+ * @param block Pointer to 64 readable bytes of input.
+ * @return The quote and comma masks of the block.
+ */
+CsvMasks CsvScanner::scanScalar(const char* block) {
+    CsvMasks masks = {0, 0};
+    for (size_t i = 0; i < blockSize; ++i) {
+        masks.quotes |= static_cast<uint64_t>(block[i] == '"') << i;
+        masks.commas |= static_cast<uint64_t>(block[i] == ',') << i;
+    }
+    return masks;
+}
+
+/**
+ * @brief Returns the name of the instruction set used by `scan`, e.g. "avx2".
+ */
+const char* CsvScanner::isa() {
+    return implementation().name;
+}
@@ -0,0 +1,39 @@
+﻿#ifndef CSVSCANNER_H
+#define CSVSCANNER_H
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct CsvMasks
+ * @brief Bit masks of the structural characters found in a 64-byte block of CSV input.
+ *
+ * Bit `i` of each mask is set when byte `i` of the block is a quote or a comma respectively.
+ */
+struct CsvMasks {
+    uint64_t quotes;
+    uint64_t commas;
+};
+
+/**
+ * @class CsvScanner
+ * @brief Locates quotes and commas in CSV input 16 to 32 bytes at a time.
+ *
+ * The scanner classifies a 64-byte block at once and returns bit masks of its quote and comma
+ * positions. The implementation is picked once at runtime based on the CPU: AVX2 compares
+ * 32 bytes per instruction, SSE2 compares 16, and a portable scalar loop is used everywhere
+ * else. All implementations return exactly the same masks.
+ *
+ * `CsvTokenizer` turns these masks into field boundaries without branching on quote state.
+ */
+class CsvScanner {
+public:
+    static constexpr size_t blockSize = 64;
+
+    static CsvMasks scan(const char* block);
+    static CsvMasks scanScalar(const char* block);
+    static const char* isa();
+};
+
+
+
+#endif //CSVSCANNER_H
@@ -0,0 +1,27 @@
+﻿#ifndef CSVTOKENIZER_H
+#define CSVTOKENIZER_H
+#include <string_view>
+#include <vector>
+
+/**
+ * @class CsvTokenizer
+ * @brief Splits a single CSV line into fields without copying any of its characters.
+ *
+ * The tokenizer scans a line exactly once and returns every field as a `std::string_view`
+ * into the caller's buffer. Commas inside quotes do not split a field, and the quotes
+ * enclosing a field are not part of the returned view. The views stay valid for as long as
+ * the buffer holding the line is alive and unchanged, so one tokenized line can feed both the
+ * `Measurement` and the `Station` builders.
+ *
+ * `tokenize` uses the vectorized `CsvScanner`; `tokenizeScalar` is the byte-at-a-time
+ * reference and produces identical fields.
+ */
+class CsvTokenizer {
+public:
+    static void tokenize(std::string_view line, std::vector<std::string_view>& fields);
+    static void tokenizeScalar(std::string_view line, std::vector<std::string_view>& fields);
+};
+
+
+
+#endif //CSVTOKENIZER_H
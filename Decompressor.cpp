@@ -0,0 +1,186 @@
+﻿#include "Decompressor.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef WEATHER_CLI_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef WEATHER_CLI_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+#ifdef WEATHER_CLI_WITH_ZLIB
+/**
+ * @brief Inflates gzip (and zlib) streams with zlib, member after member.
+ */
+class GzipDecompressor : public Decompressor {
+public:
+    explicit GzipDecompressor(std::FILE* file) : file(file), input(inputSize) {
+        // 32 lets zlib detect the gzip or zlib header itself
+        this->ready = inflateInit2(&this->stream, 15 + 32) == Z_OK;
+    }
+
+    ~GzipDecompressor() override {
+        if (this->ready) {
+            inflateEnd(&this->stream);
+        }
+    }
+
+    bool isReady() const {
+        return this->ready;
+    }
+
+    size_t read(char* output, size_t size) override {
+        this->stream.next_out = reinterpret_cast<Bytef*>(output);
+        this->stream.avail_out = static_cast<uInt>(size);
+
+        while (this->stream.avail_out > 0 && !this->finished) {
+            if (this->stream.avail_in == 0) {
+                const size_t read = std::fread(this->input.data(), 1, this->input.size(), this->file);
+                if (read == 0) {
+                    this->finished = true;
+                    if (this->inMember) {
+                        throw std::runtime_error("Truncated gzip stream.");
+                    }
+                    break;
+                }
+                this->stream.next_in = this->input.data();
+                this->stream.avail_in = static_cast<uInt>(read);
+            }
+
+            this->inMember = true;
+            const int result = inflate(&this->stream, Z_NO_FLUSH);
+            if (result == Z_STREAM_END) {
+                // Another gzip member may follow
+                inflateReset(&this->stream);
+                this->inMember = false;
+            } else if (result != Z_OK && result != Z_BUF_ERROR) {
+                this->finished = true;
+                throw std::runtime_error(std::string("Corrupt gzip stream: ") + (this->stream.msg ? this->stream.msg : "unknown error"));
+            }
+        }
+
+        return size - this->stream.avail_out;
+    }
+private:
+    std::FILE* file;
+    std::vector<Bytef> input;
+    z_stream stream = {};
+    bool ready = false;
+    bool inMember = false;
+    bool finished = false;
+};
+#endif
+
+#ifdef WEATHER_CLI_WITH_ZSTD
+/**
+ * @brief Decompresses zstd streams frame after frame.
+ */
+class ZstdDecompressor : public Decompressor {
+public:
+    explicit ZstdDecompressor(std::FILE* file) : file(file), input(ZSTD_DStreamInSize()), context(ZSTD_createDCtx()) {
+    }
+
+    ~ZstdDecompressor() override {
+        ZSTD_freeDCtx(this->context);
+    }
+
+    bool isReady() const {
+        return this->context != nullptr;
+    }
+
+    size_t read(char* output, size_t size) override {
+        ZSTD_outBuffer out = {output, size, 0};
+
+        while (out.pos < out.size && !this->finished) {
+            if (this->in.pos == this->in.size) {
+                const size_t read = std::fread(this->input.data(), 1, this->input.size(), this->file);
+                if (read == 0) {
+                    this->finished = true;
+                    // A non-zero hint means the last frame is incomplete
+                    if (this->hint != 0) {
+                        throw std::runtime_error("Truncated zstd stream.");
+                    }
+                    break;
+                }
+                this->in = {this->input.data(), read, 0};
+            }
+
+            this->hint = ZSTD_decompressStream(this->context, &out, &this->in);
+            if (ZSTD_isError(this->hint)) {
+                this->finished = true;
+                throw std::runtime_error(std::string("Corrupt zstd stream: ") + ZSTD_getErrorName(this->hint));
+            }
+        }
+
+        return out.pos;
+    }
+private:
+    std::FILE* file;
+    std::vector<char> input;
+    ZSTD_DCtx* context;
+    ZSTD_inBuffer in = {nullptr, 0, 0};
+    size_t hint = 0;
+    bool finished = false;
+};
+#endif
+
+}
+
+/**
+ * @brief Determines the compression of a file from its extension.
+ *
+ * @param path The file path, e.g. "010010-99999-2023.csv.gz".
+ * @return `Gzip` for ".gz" and ".tgz", `Zstd` for ".zst", otherwise `None`.
+ */
+Decompressor::Format Decompressor::detect(const std::filesystem::path& path) {
+    const std::filesystem::path extension = path.extension();
+    if (extension == ".gz" || extension == ".tgz") {
+        return Format::Gzip;
+    }
+    if (extension == ".zst") {
+        return Format::Zstd;
+    }
+    return Format::None;
+}
+
+/**
+ * @brief Creates a decompressor reading from an open stream.
+ *
+ * An error is reported on standard error if the format was not compiled in.
+ *
+ * @param file The compressed input; it stays owned by the caller.
+ * @param format The compression format of the input.
+ * @return The decompressor, or null if the format is not supported.
+ */
+std::unique_ptr<Decompressor> Decompressor::open(std::FILE* file, Format format) {
+    switch (format) {
+        case Format::Gzip: {
+#ifdef WEATHER_CLI_WITH_ZLIB
+            auto decompressor = std::make_unique<GzipDecompressor>(file);
+            if (decompressor->isReady()) {
+                return decompressor;
+            }
+#else
+            std::cerr << "Error: This build does not support gzip files." << std::endl;
+#endif
+            return nullptr;
+        }
+        case Format::Zstd: {
+#ifdef WEATHER_CLI_WITH_ZSTD
+            auto decompressor = std::make_unique<ZstdDecompressor>(file);
+            if (decompressor->isReady()) {
+                return decompressor;
+            }
+#else
+            std::cerr << "Error: This build does not support zstd files." << std::endl;
+#endif
+            return nullptr;
+        }
+        default:
+            return nullptr;
+    }
+}
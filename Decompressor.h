@@ -0,0 +1,49 @@
+﻿#ifndef DECOMPRESSOR_H
+#define DECOMPRESSOR_H
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+
+/**
+ * @class Decompressor
+ * @brief Streams the decompressed contents of a gzip or zstd compressed file.
+ *
+ * A decompressor reads the compressed bytes from an open stdio stream in fixed-size blocks
+ * and inflates them straight into the caller's buffer, so a compressed CSV is parsed without
+ * ever being extracted to disk or held in memory as a whole. Concatenated gzip members and
+ * zstd frames are read as one continuous stream. A truncated or corrupt stream throws, so the
+ * short output is never taken for the whole file.
+ *
+ * Support for each format is compiled in when its library is found at build time
+ * (`WEATHER_CLI_WITH_ZLIB`, `WEATHER_CLI_WITH_ZSTD`).
+ */
+class Decompressor {
+public:
+    enum class Format {
+        None,
+        Gzip,
+        Zstd,
+    };
+
+    static constexpr size_t inputSize = 1024 * 1024;
+
+    static Format detect(const std::filesystem::path& path);
+    static std::unique_ptr<Decompressor> open(std::FILE* file, Format format);
+
+    virtual ~Decompressor() = default;
+
+    /**
+     * @brief Decompresses up to `size` bytes into `output`.
+     *
+     * @param output The buffer to fill.
+     * @param size The capacity of the buffer.
+     * @return The number of bytes written; less than `size` only at the end of the stream.
+     * @throws std::runtime_error If the stream is truncated or corrupt.
+     */
+    virtual size_t read(char* output, size_t size) = 0;
+};
+
+
+
+#endif //DECOMPRESSOR_H
@@ -0,0 +1,187 @@
+﻿#include "FieldParser.h"
+#include <charconv>
+
+namespace {
+
+constexpr const char* fieldNames[] = {
+    "line",
+    "station",
+    "date",
+    "wind",
+    "cloudCeiling",
+    "visibilityDistance",
+    "temperature",
+    "dewPoints",
+    "seaLevelPressure",
+    "latitude",
+    "longitude",
+    "elevation",
+};
+
+constexpr const char* resultNames[] = {
+    "ok",
+    "empty",
+    "invalid",
+    "out of range",
+};
+
+}
+
+/**
+ * @brief Counts one conversion failure for the given field.
+ *
+ * Successful results are ignored, so callers can pass every result through unconditionally.
+ *
+ * @param field The field whose conversion was attempted.
+ * @param result The outcome of the conversion.
+ */
+void ParseErrors::record(CsvField field, ParseResult result) {
+    if (result != ParseResult::Ok) {
+        this->counts[static_cast<size_t>(field)][static_cast<size_t>(result)]++;
+    }
+}
+
+/**
+ * @brief Adds the counters of another instance to this one.
+ *
+ * @param other The counters to add, typically those of a single finished file.
+ */
+void ParseErrors::merge(const ParseErrors& other) {
+    for (size_t field = 0; field < this->counts.size(); ++field) {
+        for (size_t result = 0; result < this->counts[field].size(); ++result) {
+            this->counts[field][result] += other.counts[field][result];
+        }
+    }
+}
+
+/**
+ * @brief Returns the number of failed conversions across all fields.
+ */
+size_t ParseErrors::total() const {
+    size_t total = 0;
+    for (const auto& field : this->counts) {
+        for (const size_t count : field) {
+            total += count;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Writes one line per field and failure kind that occurred, followed by the total.
+ *
+ * Nothing is written when no conversion failed.
+ *
+ * @param out The stream to write the summary to.
+ */
+void ParseErrors::print(std::ostream& out) const {
+    if (total() == 0) {
+        return;
+    }
+
+    out << "Parse errors:\n";
+    for (size_t field = 0; field < this->counts.size(); ++field) {
+        for (size_t result = 0; result < this->counts[field].size(); ++result) {
+            if (this->counts[field][result] > 0) {
+                out << "  " << fieldNames[field] << " (" << resultNames[result] << "): "
+                    << this->counts[field][result] << '\n';
+            }
+        }
+    }
+    out << "  total: " << total() << '\n';
+}
+
+/**
+ * @brief Returns the name a field is reported under.
+ */
+const char* ParseErrors::fieldName(CsvField field) {
+    return fieldNames[static_cast<size_t>(field)];
+}
+
+/**
+ * @brief Returns the name a kind of failure is reported under.
+ */
+const char* ParseErrors::resultName(ParseResult result) {
+    return resultNames[static_cast<size_t>(result)];
+}
+
+/**
+ * @brief Converts the leading number of a field into a double.
+ *
+ * Mirrors what `std::stod` accepted before: leading spaces and an explicit plus sign are
+ * skipped, and anything following the number is ignored, so composite NOAA values such as
+ * "+0023,1" yield their first component. On failure `value` is left unchanged.
+ *
+ * @param field The field to convert.
+ * @param value Receives the converted number on success.
+ * @return `ParseResult::Ok` on success, otherwise the reason the conversion failed.
+ */
+ParseResult FieldParser::parseDouble(std::string_view field, double& value) {
+    while (!field.empty() && field.front() == ' ') {
+        field.remove_prefix(1);
+    }
+    if (field.empty()) {
+        return ParseResult::Empty;
+    }
+    if (field.front() == '+') {
+        field.remove_prefix(1);
+    }
+
+    double parsed = 0;
+    const auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), parsed);
+    if (error == std::errc::result_out_of_range) {
+        return ParseResult::OutOfRange;
+    }
+    if (error != std::errc()) {
+        return ParseResult::Invalid;
+    }
+
+    value = parsed;
+    return ParseResult::Ok;
+}
+
+/**
+ * @brief Converts a field into a double and counts a failure against its field id.
+ *
+ * @param field The field to convert.
+ * @param value Receives the converted number on success.
+ * @param id The field being converted, used for the error counters.
+ * @param errors The counters a failure is recorded in.
+ * @return The outcome of the conversion.
+ */
+ParseResult FieldParser::parseDouble(std::string_view field, double& value, CsvField id, ParseErrors& errors) {
+    const ParseResult result = parseDouble(field, value);
+    errors.record(id, result);
+    return result;
+}
+
+/**
+ * @brief Converts a whole field into a 32-bit integer.
+ *
+ * Unlike `parseDouble`, the entire field must be a number, optionally preceded by a sign,
+ * so "0050" converts while "0050,1" is rejected. On failure `value` is left unchanged.
+ *
+ * @param field The field to convert.
+ * @param value Receives the converted number on success.
+ * @return `ParseResult::Ok` on success, otherwise the reason the conversion failed.
+ */
+ParseResult FieldParser::parseInt(std::string_view field, int32_t& value) {
+    if (field.empty()) {
+        return ParseResult::Empty;
+    }
+    if (field.front() == '+') {
+        field.remove_prefix(1);
+    }
+
+    int32_t parsed = 0;
+    const auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), parsed);
+    if (error == std::errc::result_out_of_range) {
+        return ParseResult::OutOfRange;
+    }
+    if (error != std::errc() || end != field.data() + field.size()) {
+        return ParseResult::Invalid;
+    }
+
+    value = parsed;
+    return ParseResult::Ok;
+}
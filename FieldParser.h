@@ -0,0 +1,87 @@
+﻿#ifndef FIELDPARSER_H
+#define FIELDPARSER_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+/**
+ * @enum ParseResult
+ * @brief Outcome of converting a single CSV field.
+ */
+enum class ParseResult {
+    Ok,
+    Empty,
+    Invalid,
+    OutOfRange,
+};
+
+/**
+ * @enum CsvField
+ * @brief Identifies the CSV fields whose conversion failures are counted.
+ *
+ * `Line` counts lines that have too few fields to be parsed at all, `Station` lines without a
+ * station id.
+ */
+enum class CsvField : size_t {
+    Line,
+    Station,
+    Date,
+    Wind,
+    CloudCeiling,
+    VisibilityDistance,
+    Temperature,
+    DewPoints,
+    SeaLevelPressure,
+    Latitude,
+    Longitude,
+    Elevation,
+    Count,
+};
+
+/**
+ * @struct FieldError
+ * @brief A failed conversion of one field, e.g. the reason a row was rejected.
+ */
+struct FieldError {
+    CsvField field;
+    ParseResult result;
+};
+
+/**
+ * @class ParseErrors
+ * @brief Aggregates conversion failures per field and per kind of failure.
+ *
+ * Parsers record every failed conversion here instead of logging it. A load keeps one instance
+ * per file, merges them as files finish, and prints the totals once at the end.
+ */
+class ParseErrors {
+public:
+    void record(CsvField field, ParseResult result);
+    void merge(const ParseErrors& other);
+    size_t total() const;
+    void print(std::ostream& out) const;
+    static const char* fieldName(CsvField field);
+    static const char* resultName(ParseResult result);
+private:
+    std::array<std::array<size_t, 4>, static_cast<size_t>(CsvField::Count)> counts = {};
+};
+
+/**
+ * @class FieldParser
+ * @brief Converts CSV field views into numbers without throwing.
+ *
+ * Conversions use `std::from_chars` and report failures through a `ParseResult` instead of
+ * exceptions, so dirty input costs no more than clean input.
+ */
+class FieldParser {
+public:
+    static ParseResult parseDouble(std::string_view field, double& value);
+    static ParseResult parseDouble(std::string_view field, double& value, CsvField id, ParseErrors& errors);
+    static ParseResult parseInt(std::string_view field, int32_t& value);
+};
+
+
+
+#endif //FIELDPARSER_H
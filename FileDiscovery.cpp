@@ -0,0 +1,104 @@
+﻿#include "FileDiscovery.h"
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <queue>
+
+/**
+ * @brief Lists every accepted regular file below a directory, including all subdirectories.
+ *
+ * Each directory is listed by its own task on `pool`; subdirectories found by a task are
+ * submitted from that worker and picked up by idle workers, so large year directories are
+ * walked in parallel. The size and modification time of each file are read inside the tasks
+ * as well. Symbolic links to directories are not followed, which rules out cycles, and
+ * directories that cannot be read are reported and skipped.
+ *
+ * Must not be called from a task running on `pool`.
+ *
+ * @param root The directory to search.
+ * @param pool The pool to run the directory tasks on.
+ * @param accept Decides from its path whether a file is an input file.
+ * @return The accepted files, described for the manifest, in no particular order.
+ */
+std::vector<ManifestEntry> FileDiscovery::discover(const std::filesystem::path& root, ThreadPool& pool, const std::function<bool(const std::filesystem::path&)>& accept) {
+    std::mutex mutex;
+    std::vector<ManifestEntry> files;
+
+    std::function<void(std::filesystem::path)> list = [&](const std::filesystem::path& directory) {
+        std::vector<ManifestEntry> found;
+        std::error_code error;
+        std::filesystem::directory_iterator iterator(directory, std::filesystem::directory_options::skip_permission_denied, error);
+
+        for (; !error && iterator != std::filesystem::directory_iterator(); iterator.increment(error)) {
+            const std::filesystem::directory_entry& entry = *iterator;
+            std::error_code status;
+            if (entry.is_directory(status) && !entry.is_symlink(status)) {
+                pool.submit([&list, path = entry.path()] { list(path); });
+            } else if (entry.is_regular_file(status) && accept(entry.path())) {
+                found.push_back(FileManifest::describe(entry));
+            }
+        }
+
+        if (error) {
+            std::cerr << "Error: Cannot read directory " << directory.string() << ": " << error.message() << std::endl;
+        }
+
+        std::lock_guard lock(mutex);
+        files.insert(files.end(), std::make_move_iterator(found.begin()), std::make_move_iterator(found.end()));
+    };
+
+    pool.submit([&list, &root] { list(root); });
+    pool.wait();
+    return files;
+}
+
+/**
+ * @brief Orders files by size, largest first, and by path among files of equal size.
+ *
+ * Handing the largest files to the workers first is the longest-processing-time-first rule:
+ * the big files start early and the small ones fill the gaps at the end, instead of one
+ * worker starting a huge file just as all others run out of work.
+ *
+ * @param files The files to order.
+ */
+void FileDiscovery::sortLargestFirst(std::vector<ManifestEntry>& files) {
+    std::sort(files.begin(), files.end(), [](const ManifestEntry& a, const ManifestEntry& b) {
+        return a.size != b.size ? a.size > b.size : a.path < b.path;
+    });
+}
+
+/**
+ * @brief Splits files into batches of about equal total size.
+ *
+ * Files are taken largest first and each goes to the batch with the fewest bytes so far
+ * (longest-processing-time-first scheduling), which keeps the largest batch within 4/3 of
+ * the best possible split. Within a batch the files stay largest first.
+ *
+ * This fixed split is for the sequential `--batch` load. The pooled load only needs
+ * `sortLargestFirst`, as its workers take the next file whenever they become idle.
+ *
+ * @param files The files to split.
+ * @param batches The number of batches; at least one is returned if there are files.
+ * @return The batches, none of them empty.
+ */
+std::vector<std::vector<ManifestEntry>> FileDiscovery::balance(std::vector<ManifestEntry> files, size_t batches) {
+    sortLargestFirst(files);
+    batches = std::clamp<size_t>(batches, 1, std::max<size_t>(files.size(), 1));
+
+    std::vector<std::vector<ManifestEntry>> result(batches);
+    using Load = std::pair<int64_t, size_t>;
+    std::priority_queue<Load, std::vector<Load>, std::greater<>> lightest;
+    for (size_t i = 0; i < batches; ++i) {
+        lightest.emplace(0, i);
+    }
+
+    for (ManifestEntry& file : files) {
+        auto [bytes, index] = lightest.top();
+        lightest.pop();
+        lightest.emplace(bytes + file.size, index);
+        result[index].push_back(std::move(file));
+    }
+
+    std::erase_if(result, [](const std::vector<ManifestEntry>& batch) { return batch.empty(); });
+    return result;
+}
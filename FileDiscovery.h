@@ -0,0 +1,28 @@
+﻿#ifndef FILEDISCOVERY_H
+#define FILEDISCOVERY_H
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+#include "FileManifest.h"
+#include "ThreadPool.h"
+
+/**
+ * @class FileDiscovery
+ * @brief Finds the input files below a directory and schedules them by size.
+ *
+ * NOAA mirrors keep one subdirectory per year with thousands of files each. `discover` walks
+ * such a tree recursively, one pool task per directory, so subtrees are listed and their
+ * files stat'ed in parallel. `balance` then spreads the files over batches by bytes rather
+ * than by count.
+ */
+class FileDiscovery {
+public:
+    static std::vector<ManifestEntry> discover(const std::filesystem::path& root, ThreadPool& pool, const std::function<bool(const std::filesystem::path&)>& accept);
+    static void sortLargestFirst(std::vector<ManifestEntry>& files);
+    static std::vector<std::vector<ManifestEntry>> balance(std::vector<ManifestEntry> files, size_t batches);
+};
+
+
+
+#endif //FILEDISCOVERY_H
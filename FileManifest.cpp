@@ -0,0 +1,147 @@
+﻿#include "FileManifest.h"
+#include <cstring>
+#include <exception>
+
+#include "FileReader.h"
+
+namespace {
+
+constexpr uint64_t multiplier = 0x9FB21C651E98DF25;
+
+uint64_t rotate(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t mix(uint64_t state, uint64_t word) {
+    return rotate((state ^ word) * multiplier, 29);
+}
+
+}
+
+/**
+ * @brief Adds one line to the hash, followed by a line terminator.
+ *
+ * A trailing carriage return is dropped first, so a file hashes the same with Unix and
+ * Windows line endings.
+ *
+ * @param line The line without its newline, as returned by `FileReader::nextLine`.
+ */
+void ContentHash::update(std::string_view line) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+
+    const char* data = line.data();
+    size_t remaining = line.size();
+    while (remaining >= sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        this->state = mix(this->state, word);
+        data += sizeof(word);
+        remaining -= sizeof(word);
+    }
+
+    // The tail and the terminator form the last word, so a line boundary always changes the state
+    uint64_t tail = '\n';
+    for (size_t i = 0; i < remaining; ++i) {
+        tail = (tail << 8) | static_cast<unsigned char>(data[i]);
+    }
+    this->state = mix(this->state, tail);
+    this->length += line.size() + 1;
+}
+
+/**
+ * @brief Returns the hash of everything added so far as 16 hexadecimal digits.
+ */
+std::string ContentHash::hex() const {
+    uint64_t value = this->state ^ this->length;
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCD;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53;
+    value ^= value >> 33;
+
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string text(16, '0');
+    for (size_t i = 0; i < text.size(); ++i) {
+        text[text.size() - 1 - i] = digits[(value >> (i * 4)) & 0xF];
+    }
+    return text;
+}
+
+/**
+ * @brief Reads the path, size and modification time of a file, without hashing it.
+ *
+ * @param entry The directory entry of the file.
+ * @return A manifest entry with an empty `id` and `hash`.
+ */
+ManifestEntry FileManifest::describe(const std::filesystem::directory_entry& entry) {
+    ManifestEntry manifestEntry;
+    manifestEntry.path = entry.path().string();
+    manifestEntry.size = static_cast<int64_t>(entry.file_size());
+    manifestEntry.mtime = static_cast<int64_t>(entry.last_write_time().time_since_epoch().count());
+    return manifestEntry;
+}
+
+/**
+ * @brief Computes the content hash of a whole file.
+ *
+ * The result equals the hash the loader computes while parsing the same file, so it can be
+ * compared against the manifest.
+ *
+ * @param path The file to hash.
+ * @return The hash, or an empty string if the file cannot be opened or read to its end.
+ */
+std::string FileManifest::hash(const std::filesystem::path& path) {
+    FileReader file(path);
+    if (!file.isOpen()) {
+        return {};
+    }
+
+    ContentHash hash;
+    std::string_view line;
+    try {
+        while (file.nextLine(line)) {
+            hash.update(line);
+        }
+    } catch (const std::exception&) {
+        // A damaged compressed file counts as changed and is loaded, where the error is reported
+        return {};
+    }
+    return hash.hex();
+}
+
+/**
+ * @brief Computes the content hash of file contents held in memory, such as an archive member.
+ *
+ * Lines are split as `FileReader::nextLine` splits them, so the result equals the hash of the
+ * same contents read from a file.
+ *
+ * @param contents The whole contents.
+ * @return The hash.
+ */
+std::string FileManifest::hashContents(std::string_view contents) {
+    ContentHash hash;
+    while (!contents.empty()) {
+        const size_t newline = contents.find('\n');
+        if (newline == std::string_view::npos) {
+            hash.update(contents);
+            break;
+        }
+        hash.update(contents.substr(0, newline));
+        contents.remove_prefix(newline + 1);
+    }
+    return hash.hex();
+}
+
+/**
+ * @brief Checks whether a completely loaded file still has the size and modification time
+ *        recorded in the manifest.
+ *
+ * @param stored The manifest row from the database.
+ * @param current The entry describing the file on disk.
+ * @return True if the file can be skipped without hashing it.
+ */
+bool FileManifest::unchanged(const ManifestEntry& stored, const ManifestEntry& current) {
+    return !stored.hash.empty() && stored.size == current.size && stored.mtime == current.mtime;
+}
@@ -0,0 +1,57 @@
+﻿#ifndef FILEMANIFEST_H
+#define FILEMANIFEST_H
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+/**
+ * @struct ManifestEntry
+ * @brief One row of the `files` manifest: a source file as it was when it was loaded.
+ *
+ * `id` is the manifest row the file's measurements refer to, 0 for a file not recorded yet.
+ * `mtime` is the file's last write time in the filesystem clock's native ticks; it is only
+ * ever compared for equality. `hash` is empty until the file has been loaded completely.
+ */
+struct ManifestEntry {
+    int64_t id = 0;
+    std::string path;
+    int64_t size = 0;
+    int64_t mtime = 0;
+    std::string hash;
+};
+
+/**
+ * @class ContentHash
+ * @brief Incremental 64-bit hash of a file's lines, used to detect changed source files.
+ *
+ * The hash is fed line by line, so it can be computed while the loader parses a file without
+ * a second pass over the data, and it does not depend on whether the last line ends with a
+ * newline or on Windows line endings. It processes eight bytes per step and is meant for
+ * change detection only, not as a cryptographic digest.
+ */
+class ContentHash {
+public:
+    void update(std::string_view line);
+    std::string hex() const;
+private:
+    uint64_t state = 0x9E3779B97F4A7C15;
+    uint64_t length = 0;
+};
+
+/**
+ * @class FileManifest
+ * @brief Describes source files for the manifest, which lets `load --append` skip files that
+ *        were loaded before and have not changed since.
+ */
+class FileManifest {
+public:
+    static ManifestEntry describe(const std::filesystem::directory_entry& entry);
+    static std::string hash(const std::filesystem::path& path);
+    static std::string hashContents(std::string_view contents);
+    static bool unchanged(const ManifestEntry& stored, const ManifestEntry& current);
+};
+
+
+
+#endif //FILEMANIFEST_H
@@ -0,0 +1,313 @@
+﻿#include "FileReader.h"
+#include <cstring>
+
+#include "Decompressor.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Opens a file for line-by-line reading, preferring a memory mapping.
+ *
+ * The constructor first tries to map the whole file read-only. If the file is empty, is not a
+ * regular file, exceeds `maxMappedSize`, or the mapping fails for any other reason, the file is
+ * opened as an unbuffered stream and read through a `bufferSize` block buffer instead.
+ * Compressed files are always streamed, through a decompressor for their format; if the format
+ * is not supported by this build the reader stays closed.
+ *
+ * Whether opening succeeded at all can be checked with `isOpen`.
+ *
+ * @param path The path of the file to read.
+ */
+FileReader::FileReader(const std::filesystem::path& path) {
+    const Decompressor::Format format = Decompressor::detect(path);
+    if (format == Decompressor::Format::None && map(path)) {
+        return;
+    }
+
+#ifdef _WIN32
+    this->stream = _wfopen(path.c_str(), L"rb");
+#else
+    this->stream = std::fopen(path.c_str(), "rb");
+#endif
+    if (this->stream != nullptr) {
+        // The block buffer below replaces the stdio buffer, avoiding a second copy
+        std::setvbuf(this->stream, nullptr, _IONBF, 0);
+
+        if (format != Decompressor::Format::None) {
+            this->decompressor = Decompressor::open(this->stream, format);
+            if (this->decompressor == nullptr) {
+                std::fclose(this->stream);
+                this->stream = nullptr;
+                return;
+            }
+        }
+
+        this->buffer.resize(bufferSize);
+        this->data = this->buffer.data();
+    }
+}
+
+/**
+ * @brief Serves lines from contents that are already in memory.
+ *
+ * @param contents The complete file contents; the reader takes ownership.
+ */
+FileReader::FileReader(std::vector<char> contents) : buffer(std::move(contents)) {
+    // Keep the buffer non-empty so the reader counts as open even for empty contents
+    this->size = this->buffer.size();
+    this->buffer.push_back('\n');
+    this->data = this->buffer.data();
+    this->endOfStream = true;
+}
+
+/**
+ * @brief Streams lines from a source, through the same block buffer as a streamed file.
+ *
+ * Only `bufferSize` bytes, or the longest line, are held at a time, however much the source
+ * delivers.
+ *
+ * @param source Fills the buffer; it is called until it returns fewer bytes than requested.
+ */
+FileReader::FileReader(Source source) : source(std::move(source)) {
+    this->buffer.resize(bufferSize);
+    this->data = this->buffer.data();
+}
+
+/**
+ * @brief Serves the lines of a byte range of another reader's mapping.
+ *
+ * The range is borrowed, not copied: `parent` must stay alive while this reader is used.
+ *
+ * @param parent A mapped reader.
+ * @param range A view into `parent.contents()`, normally starting at a line boundary.
+ */
+FileReader::FileReader(const FileReader& parent, std::string_view range) {
+    if (parent.isMapped()) {
+        this->data = range.data();
+        this->size = range.size();
+        this->borrowed = true;
+    }
+}
+
+/**
+ * @brief Releases the mapping or closes the stream, whichever is in use.
+ */
+FileReader::~FileReader() {
+    this->decompressor.reset();
+    unmap();
+    if (this->stream != nullptr) {
+        std::fclose(this->stream);
+    }
+}
+
+/**
+ * @brief Reports whether the file could be opened, either mapped or as a stream.
+ */
+bool FileReader::isOpen() const {
+    return this->data != nullptr;
+}
+
+/**
+ * @brief Reports whether the file is served from a memory mapping.
+ */
+bool FileReader::isMapped() const {
+    return this->buffer.empty() && this->data != nullptr;
+}
+
+/**
+ * @brief Asks the operating system to start reading the mapped file into memory.
+ *
+ * The call returns immediately; the pages are read in the background, so a pipeline stage
+ * can open the next file while the current one is being parsed. It has no effect on
+ * streamed files.
+ */
+void FileReader::prefetch() const {
+    if (!isMapped()) {
+        return;
+    }
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range = {const_cast<char*>(this->data), this->size};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    ::madvise(const_cast<char*>(this->data), this->size, MADV_WILLNEED);
+#endif
+}
+
+/**
+ * @brief Returns the whole mapped file, or an empty view for streamed files.
+ */
+std::string_view FileReader::contents() const {
+    return isMapped() ? std::string_view(this->data, this->size) : std::string_view();
+}
+
+/**
+ * @brief Returns the next line of the file as a view without its line terminator.
+ *
+ * For mapped files the view points straight into the mapping. For streamed files it points
+ * into the block buffer, which is refilled as needed; a line longer than the buffer grows it.
+ * A final line without a trailing newline is still returned.
+ *
+ * @param line Receives the view of the next line. It stays valid until the next call.
+ * @return True if a line was returned, false once the end of the file has been reached.
+ */
+bool FileReader::nextLine(std::string_view& line) {
+    while (true) {
+        const char* begin = this->data + this->position;
+        const size_t remaining = this->size - this->position;
+        const void* newline = remaining > 0 ? std::memchr(begin, '\n', remaining) : nullptr;
+
+        if (newline != nullptr) {
+            const size_t length = static_cast<const char*>(newline) - begin;
+            line = std::string_view(begin, length);
+            this->position += length + 1;
+            return true;
+        }
+
+        if (isMapped() || this->endOfStream) {
+            if (remaining == 0) {
+                return false;
+            }
+            line = std::string_view(begin, remaining);
+            this->position = this->size;
+            return true;
+        }
+
+        fillBuffer();
+    }
+}
+
+/**
+ * @brief Maps the whole file into memory and advises the kernel of sequential access.
+ *
+ * @param path The path of the file to map.
+ * @return True if the file is now mapped, false if it has to be streamed instead.
+ */
+bool FileReader::map(const std::filesystem::path& path) {
+#ifdef _WIN32
+    HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    this->file = handle;
+
+    LARGE_INTEGER fileSize;
+    if (GetFileType(handle) != FILE_TYPE_DISK || !GetFileSizeEx(handle, &fileSize) ||
+        fileSize.QuadPart <= 0 || static_cast<unsigned long long>(fileSize.QuadPart) > maxMappedSize) {
+        unmap();
+        return false;
+    }
+
+    this->mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (this->mapping == nullptr) {
+        unmap();
+        return false;
+    }
+
+    const void* view = MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        unmap();
+        return false;
+    }
+
+    this->data = static_cast<const char*>(view);
+    this->size = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+#else
+    this->descriptor = ::open(path.c_str(), O_RDONLY);
+    if (this->descriptor < 0) {
+        return false;
+    }
+
+    struct stat status = {};
+    if (::fstat(this->descriptor, &status) != 0 || !S_ISREG(status.st_mode) ||
+        status.st_size <= 0 || static_cast<unsigned long long>(status.st_size) > maxMappedSize) {
+        unmap();
+        return false;
+    }
+
+    void* view = ::mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, this->descriptor, 0);
+    if (view == MAP_FAILED) {
+        unmap();
+        return false;
+    }
+    ::madvise(view, status.st_size, MADV_SEQUENTIAL);
+
+    this->data = static_cast<const char*>(view);
+    this->size = static_cast<size_t>(status.st_size);
+    return true;
+#endif
+}
+
+/**
+ * @brief Releases the mapping and its handles, if any.
+ */
+void FileReader::unmap() {
+#ifdef _WIN32
+    if (isMapped() && !this->borrowed) {
+        UnmapViewOfFile(this->data);
+    }
+    if (this->mapping != nullptr) {
+        CloseHandle(this->mapping);
+        this->mapping = nullptr;
+    }
+    if (this->file != nullptr) {
+        CloseHandle(this->file);
+        this->file = nullptr;
+    }
+#else
+    if (isMapped() && !this->borrowed) {
+        ::munmap(const_cast<char*>(this->data), this->size);
+    }
+    if (this->descriptor >= 0) {
+        ::close(this->descriptor);
+        this->descriptor = -1;
+    }
+#endif
+    if (this->buffer.empty()) {
+        this->data = nullptr;
+        this->size = 0;
+    }
+}
+
+/**
+ * @brief Moves the unread tail of the buffer to its front and reads the next block behind it.
+ *
+ * If the unread tail already fills the buffer, i.e. a single line is longer than the buffer,
+ * the buffer is doubled first. Compressed files are decompressed straight into the buffer, and
+ * a `Source` writes into it directly as well.
+ *
+ * @return True if any bytes were read, false if the end of the stream was reached.
+ */
+bool FileReader::fillBuffer() {
+    const size_t unread = this->size - this->position;
+    std::memmove(this->buffer.data(), this->buffer.data() + this->position, unread);
+    if (unread == this->buffer.size()) {
+        this->buffer.resize(this->buffer.size() * 2);
+    }
+
+    const size_t requested = this->buffer.size() - unread;
+    size_t read = 0;
+    if (this->source) {
+        read = this->source(this->buffer.data() + unread, requested);
+    } else if (this->decompressor != nullptr) {
+        read = this->decompressor->read(this->buffer.data() + unread, requested);
+    } else {
+        read = std::fread(this->buffer.data() + unread, 1, requested, this->stream);
+    }
+    if (read < requested) {
+        this->endOfStream = true;
+    }
+
+    this->data = this->buffer.data();
+    this->size = unread + read;
+    this->position = 0;
+    return read > 0;
+}
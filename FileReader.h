@@ -0,0 +1,76 @@
+﻿#ifndef FILEREADER_H
+#define FILEREADER_H
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class FileReader
+ * @brief Reads a text file line by line without copying its contents per line.
+ *
+ * The reader memory-maps the file and hands out every line as a `std::string_view` into the
+ * mapping, with the kernel told that the file is read sequentially. Files that cannot be
+ * mapped, such as empty files, pipes, or files larger than `maxMappedSize`, are read in large
+ * blocks into one reusable buffer instead; lines are then views into that buffer. Files ending
+ * in ".gz" or ".zst" are decompressed on the fly into that buffer by a `Decompressor`. A reader
+ * can also be given contents already in memory, such as a small member of a tar archive, a
+ * `Source` that fills the buffer block by block, such as a large member streamed out of an
+ * archive, or a byte range of a mapped file, so that parts of one large file can be parsed in
+ * parallel.
+ *
+ * A line view is valid until the next call to `nextLine` or until the reader is destroyed.
+ * Line terminators are not part of the view. `nextLine` passes on the exception of a
+ * `Decompressor` or `Source` that cannot deliver the rest of the stream.
+ */
+class Decompressor;
+
+class FileReader {
+public:
+    // Writes up to the given number of bytes and returns how many it wrote; fewer only at the end
+    using Source = std::function<size_t(char*, size_t)>;
+
+    static constexpr size_t bufferSize = 4 * 1024 * 1024;
+    static constexpr unsigned long long maxMappedSize = sizeof(void*) >= 8 ? 1ull << 40 : 1ull << 29;
+
+    explicit FileReader(const std::filesystem::path& path);
+    explicit FileReader(std::vector<char> contents);
+    explicit FileReader(Source source);
+    FileReader(const FileReader& parent, std::string_view range);
+    FileReader(const FileReader&) = delete;
+    FileReader& operator=(const FileReader&) = delete;
+    ~FileReader();
+
+    bool isOpen() const;
+    bool isMapped() const;
+    void prefetch() const;
+    std::string_view contents() const;
+    bool nextLine(std::string_view& line);
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t position = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#else
+    int descriptor = -1;
+#endif
+
+    std::FILE* stream = nullptr;
+    std::unique_ptr<Decompressor> decompressor;
+    Source source;
+    std::vector<char> buffer;
+    bool endOfStream = false;
+    bool borrowed = false;
+
+    bool map(const std::filesystem::path& path);
+    void unmap();
+    bool fillBuffer();
+};
+
+
+
+#endif //FILEREADER_H
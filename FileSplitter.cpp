@@ -0,0 +1,80 @@
+﻿#include "FileSplitter.h"
+#include <algorithm>
+#include <bit>
+#include <future>
+
+#include "CsvScanner.h"
+
+/**
+ * @brief Splits file contents into consecutive ranges of whole records.
+ *
+ * Every range except the last ends right after a newline that is outside quotes, so each one
+ * can be parsed on its own. Ranges are about `rangeSize` bytes; a record longer than that
+ * simply makes its range longer. Together the ranges cover `contents` exactly, in order.
+ *
+ * Must not be called from a task running on `pool`.
+ *
+ * @param contents The complete file contents, e.g. a memory mapping.
+ * @param rangeSize The target size of a range in bytes.
+ * @param pool The pool the quote counting runs on.
+ * @return The ranges, as views into `contents`.
+ */
+std::vector<std::string_view> FileSplitter::split(std::string_view contents, size_t rangeSize, ThreadPool& pool) {
+    const size_t blocks = (contents.size() + rangeSize - 1) / rangeSize;
+
+    // Only the blocks before the last one decide where a boundary lies
+    std::vector<std::future<bool>> parities;
+    for (size_t block = 0; block + 1 < blocks; ++block) {
+        parities.push_back(pool.async([contents, block, rangeSize] {
+            return oddQuotes(contents.substr(block * rangeSize, rangeSize));
+        }));
+    }
+
+    std::vector<std::string_view> ranges;
+    size_t begin = 0;
+    bool inQuotes = false;
+    for (size_t block = 1; block < blocks; ++block) {
+        inQuotes ^= parities[block - 1].get();
+
+        size_t position = block * rangeSize;
+        if (position < begin) {
+            // The previous range already extends past this block start
+            continue;
+        }
+
+        bool quoted = inQuotes;
+        while (position < contents.size() && (quoted || contents[position] != '\n')) {
+            quoted ^= contents[position] == '"';
+            ++position;
+        }
+
+        const size_t end = std::min(position + 1, contents.size());
+        ranges.push_back(contents.substr(begin, end - begin));
+        begin = end;
+    }
+
+    if (begin < contents.size() || ranges.empty()) {
+        ranges.push_back(contents.substr(begin));
+    }
+    return ranges;
+}
+
+/**
+ * @brief Reports whether a text contains an odd number of quote characters.
+ *
+ * Full 64-byte blocks are classified with `CsvScanner`, so the count runs at SIMD speed.
+ *
+ * @param text The text to scan.
+ * @return True if the number of quotes is odd.
+ */
+bool FileSplitter::oddQuotes(std::string_view text) {
+    size_t count = 0;
+    size_t offset = 0;
+    for (; offset + CsvScanner::blockSize <= text.size(); offset += CsvScanner::blockSize) {
+        count += std::popcount(CsvScanner::scan(text.data() + offset).quotes);
+    }
+    for (; offset < text.size(); ++offset) {
+        count += text[offset] == '"';
+    }
+    return count % 2 != 0;
+}
@@ -0,0 +1,26 @@
+﻿#ifndef FILESPLITTER_H
+#define FILESPLITTER_H
+#include <string_view>
+#include <vector>
+
+#include "ThreadPool.h"
+
+/**
+ * @class FileSplitter
+ * @brief Cuts the contents of a large CSV file into byte ranges that start on record boundaries.
+ *
+ * A range boundary must not fall inside a quoted field, and whether an offset lies inside
+ * quotes depends on every quote before it. The splitter therefore works in two passes: the
+ * quote parity of every fixed-size block is counted in parallel on the pool, a prefix over
+ * those parities gives the quote state at each block start, and from there each boundary is
+ * moved forward to the end of the first line that ends outside quotes.
+ */
+class FileSplitter {
+public:
+    static std::vector<std::string_view> split(std::string_view contents, size_t rangeSize, ThreadPool& pool);
+    static bool oddQuotes(std::string_view text);
+};
+
+
+
+#endif //FILESPLITTER_H
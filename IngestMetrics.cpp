@@ -0,0 +1,222 @@
+﻿#include "IngestMetrics.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+// Report keys, in the order of `IngestStage`
+constexpr std::string_view stageNames[] = {
+    "discovery",
+    "read",
+    "parse",
+    "dedupe",
+    "bind",
+    "commit",
+};
+
+static_assert(std::size(stageNames) == static_cast<size_t>(IngestStage::Count));
+
+double seconds(IngestMetrics::Clock::duration elapsed) {
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+double seconds(int64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1e9;
+}
+
+int64_t nanoseconds(IngestMetrics::Clock::duration elapsed) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+}
+
+/**
+ * @brief Clears the figures of an earlier load and starts the wall clock; call before the
+ *        first stage of a load.
+ */
+void IngestMetrics::start() {
+    for (std::atomic<int64_t>& stage : this->stages) {
+        stage = 0;
+    }
+    this->files = 0;
+    this->bytes = 0;
+    this->rows = 0;
+    this->rejected = 0;
+    this->pushWait = 0;
+    this->popWait = 0;
+    {
+        std::lock_guard lock(this->mutex);
+        this->threads.clear();
+    }
+    this->elapsed = {};
+    this->peakResident = 0;
+    this->started = Clock::now();
+}
+
+/**
+ * @brief Stops the wall clock of the load and samples the peak resident set size.
+ */
+void IngestMetrics::finish() {
+    this->elapsed = Clock::now() - this->started;
+    this->peakResident = peakResidentBytes();
+}
+
+/**
+ * @brief Adds time spent in a stage.
+ */
+void IngestMetrics::addStage(IngestStage stage, Clock::duration elapsed) {
+    this->stages[static_cast<size_t>(stage)] += nanoseconds(elapsed);
+}
+
+/**
+ * @brief Counts an opened input file with its size on disk.
+ */
+void IngestMetrics::addFile(size_t bytes) {
+    this->files++;
+    this->bytes += bytes;
+}
+
+/**
+ * @brief Counts a parsed chunk for the calling thread.
+ *
+ * @param rows The rows of the chunk that were accepted.
+ * @param rejected The rows of the chunk that were rejected.
+ * @param elapsed The time spent parsing the chunk.
+ */
+void IngestMetrics::addParsed(size_t rows, size_t rejected, Clock::duration elapsed) {
+    this->rows += rows;
+    this->rejected += rejected;
+    this->stages[static_cast<size_t>(IngestStage::Parse)] += nanoseconds(elapsed);
+
+    const std::thread::id thread = std::this_thread::get_id();
+    std::lock_guard lock(this->mutex);
+    auto totals = std::find_if(this->threads.begin(), this->threads.end(), [&](const ThreadTotals& each) {
+        return each.thread == thread;
+    });
+    if (totals == this->threads.end()) {
+        totals = this->threads.insert(this->threads.end(), ThreadTotals{thread});
+    }
+    totals->rows += rows + rejected;
+    totals->parse += elapsed;
+}
+
+/**
+ * @brief Adds time a parser was blocked handing a chunk to the writer.
+ */
+void IngestMetrics::addPushWait(Clock::duration elapsed) {
+    this->pushWait += nanoseconds(elapsed);
+}
+
+/**
+ * @brief Adds time the writer waited for the next chunk.
+ */
+void IngestMetrics::addPopWait(Clock::duration elapsed) {
+    this->popWait += nanoseconds(elapsed);
+}
+
+/**
+ * @brief Writes the report as a JSON object.
+ *
+ * Times are in seconds. `threads` lists the parser threads in the order they first finished
+ * a chunk.
+ *
+ * @param out The stream to write the report to.
+ */
+void IngestMetrics::writeJson(std::ostream& out) const {
+    const double total = seconds(this->elapsed);
+    const size_t parsedRows = this->rows + this->rejected;
+
+    out << std::fixed << std::setprecision(6);
+    out << "{\n";
+    out << "  \"elapsedSeconds\": " << total << ",\n";
+    out << "  \"stages\": {";
+    for (size_t stage = 0; stage < this->stages.size(); ++stage) {
+        out << (stage == 0 ? "" : ",") << "\n    \"" << stageNames[stage] << "\": " << seconds(this->stages[stage].load());
+    }
+    out << "\n  },\n";
+    out << "  \"files\": " << this->files << ",\n";
+    out << "  \"bytes\": " << this->bytes << ",\n";
+    out << "  \"rows\": " << this->rows << ",\n";
+    out << "  \"rejectedRows\": " << this->rejected << ",\n";
+    out << "  \"rowsPerSecond\": " << perSecond(static_cast<double>(parsedRows), total) << ",\n";
+    out << "  \"bytesPerSecond\": " << perSecond(static_cast<double>(this->bytes), total) << ",\n";
+    out << "  \"threads\": [";
+    {
+        std::lock_guard lock(this->mutex);
+        for (size_t index = 0; index < this->threads.size(); ++index) {
+            const ThreadTotals& totals = this->threads[index];
+            out << (index == 0 ? "" : ",") << "\n    {\"rows\": " << totals.rows
+                << ", \"parseSeconds\": " << seconds(totals.parse)
+                << ", \"rowsPerSecond\": " << perSecond(static_cast<double>(totals.rows), seconds(totals.parse)) << "}";
+        }
+        out << (this->threads.empty() ? "" : "\n  ");
+    }
+    out << "],\n";
+    out << "  \"queueWait\": {\n";
+    out << "    \"parsers\": " << seconds(this->pushWait.load()) << ",\n";
+    out << "    \"writer\": " << seconds(this->popWait.load()) << "\n";
+    out << "  },\n";
+    out << "  \"peakRssBytes\": " << this->peakResident << "\n";
+    out << "}\n";
+}
+
+/**
+ * @brief Writes the report to a file, replacing an existing one.
+ *
+ * @param path The JSON file to write.
+ * @return False if the file could not be written.
+ */
+bool IngestMetrics::write(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error: Cannot write load metrics to " << path << std::endl;
+        return false;
+    }
+    writeJson(out);
+    return static_cast<bool>(out);
+}
+
+/**
+ * @brief Returns a rate, or 0 if no time was measured, e.g. for an empty input.
+ *
+ * @param count The amount processed, such as rows or bytes.
+ * @param seconds The time it took.
+ */
+double IngestMetrics::perSecond(double count, double seconds) {
+    return seconds > 0 ? count / seconds : 0;
+}
+
+/**
+ * @brief Returns the largest resident set size of the process so far, in bytes, or 0 if the
+ *        platform does not report it.
+ */
+size_t IngestMetrics::peakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    // Linux reports kilobytes
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
@@ -0,0 +1,105 @@
+﻿#ifndef INGESTMETRICS_H
+#define INGESTMETRICS_H
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @enum IngestStage
+ * @brief The stages of a load that are timed separately.
+ *
+ * - Discovery: finding the candidate files below the load path.
+ * - Read: opening, mapping or decompressing files and reading archive members.
+ * - Parse: tokenizing and converting lines into chunks, on the parser threads.
+ * - Dedupe: checking files against the manifest, hashing changed ones and deleting their rows.
+ * - Bind: binding and executing the INSERT statements of the chunks.
+ * - Commit: committing the transactions.
+ */
+enum class IngestStage : size_t {
+    Discovery,
+    Read,
+    Parse,
+    Dedupe,
+    Bind,
+    Commit,
+    Count,
+};
+
+/**
+ * @class IngestMetrics
+ * @brief Collects the timings and volumes of one load for a machine-readable report.
+ *
+ * Stage times are summed over all threads that work on a stage, so with several parser threads
+ * the parse time exceeds the wall-clock time of the load. The parse time of every thread is
+ * also kept on its own, with the rows it parsed, to give the rows per second of each thread.
+ * Queue waits are the time parsers spent blocked on a full writer queue and the time the
+ * writer spent waiting for the next chunk.
+ *
+ * Everything is recorded per file or per chunk, never per row, so the metrics cost nothing
+ * measurable. All `add` methods are thread-safe.
+ */
+class IngestMetrics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @class Timer
+     * @brief Adds the time from its construction to its destruction to a stage.
+     */
+    class Timer {
+    public:
+        Timer(IngestMetrics& metrics, IngestStage stage) : metrics(metrics), stage(stage), start(Clock::now()) {
+        }
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+        ~Timer() {
+            this->metrics.addStage(this->stage, Clock::now() - this->start);
+        }
+    private:
+        IngestMetrics& metrics;
+        IngestStage stage;
+        Clock::time_point start;
+    };
+
+    void start();
+    void finish();
+    void addStage(IngestStage stage, Clock::duration elapsed);
+    void addFile(size_t bytes);
+    void addParsed(size_t rows, size_t rejected, Clock::duration elapsed);
+    void addPushWait(Clock::duration elapsed);
+    void addPopWait(Clock::duration elapsed);
+    void writeJson(std::ostream& out) const;
+    bool write(const std::string& path) const;
+    static double perSecond(double count, double seconds);
+    static size_t peakResidentBytes();
+private:
+    struct ThreadTotals {
+        std::thread::id thread;
+        size_t rows = 0;
+        Clock::duration parse{};
+    };
+
+    std::array<std::atomic<int64_t>, static_cast<size_t>(IngestStage::Count)> stages{};
+    std::atomic<size_t> files = 0;
+    std::atomic<size_t> bytes = 0;
+    std::atomic<size_t> rows = 0;
+    std::atomic<size_t> rejected = 0;
+    std::atomic<int64_t> pushWait = 0;
+    std::atomic<int64_t> popWait = 0;
+    mutable std::mutex mutex;
+    std::vector<ThreadTotals> threads;
+    Clock::time_point started;
+    Clock::duration elapsed{};
+    size_t peakResident = 0;
+};
+
+
+
+#endif //INGESTMETRICS_H
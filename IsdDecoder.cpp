@@ -0,0 +1,151 @@
+﻿#include "IsdDecoder.h"
+#include <array>
+#include <cstring>
+
+namespace {
+
+constexpr IsdComponent value(size_t offset, int32_t missing) {
+    return {IsdComponentKind::Value, offset, missing};
+}
+
+constexpr IsdComponent code(size_t offset) {
+    return {IsdComponentKind::Code, offset, 0};
+}
+
+// WND: direction, quality, type, speed, quality
+constexpr std::array windLayout = {
+    value(offsetof(IsdWind, direction), 999),
+    code(offsetof(IsdWind, directionQuality)),
+    code(offsetof(IsdWind, type)),
+    value(offsetof(IsdWind, speed), 9999),
+    code(offsetof(IsdWind, speedQuality)),
+};
+
+// CIG: height, quality, determination, CAVOK
+constexpr std::array ceilingLayout = {
+    value(offsetof(IsdCeiling, height), 99999),
+    code(offsetof(IsdCeiling, quality)),
+    code(offsetof(IsdCeiling, determination)),
+    code(offsetof(IsdCeiling, cavok)),
+};
+
+// VIS: distance, quality, variability, quality
+constexpr std::array visibilityLayout = {
+    value(offsetof(IsdVisibility, distance), 999999),
+    code(offsetof(IsdVisibility, quality)),
+    code(offsetof(IsdVisibility, variability)),
+    code(offsetof(IsdVisibility, variabilityQuality)),
+};
+
+// TMP and DEW: signed temperature, quality
+constexpr std::array temperatureLayout = {
+    value(offsetof(IsdReading, value), 9999),
+    code(offsetof(IsdReading, quality)),
+};
+
+// SLP: pressure, quality
+constexpr std::array pressureLayout = {
+    value(offsetof(IsdReading, value), 99999),
+    code(offsetof(IsdReading, quality)),
+};
+
+}
+
+/**
+ * @brief Decodes a raw ISD section into the members described by a layout.
+ *
+ * The field is split at its commas and each component is stored at the offset its layout
+ * entry names within `target`. Values are parsed as signed integers in NOAA's fixed-point
+ * scale and replaced by `isdMissing` when they equal the layout's missing sentinel. Codes are
+ * single characters stored as-is.
+ *
+ * Every member is reset before decoding, so a section that fails to decode reads as missing
+ * rather than holding stale data.
+ *
+ * @param field The raw section, e.g. "180,1,N,0050,1".
+ * @param layout The components the section consists of, in order.
+ * @param target The decoded struct the layout's offsets refer to.
+ * @return `ParseResult::Ok` if every component was decoded, otherwise the first failure.
+ */
+ParseResult IsdDecoder::decode(std::string_view field, std::span<const IsdComponent> layout, void* target) {
+    auto* base = static_cast<char*>(target);
+    for (const IsdComponent& component : layout) {
+        if (component.kind == IsdComponentKind::Value) {
+            std::memcpy(base + component.offset, &isdMissing, sizeof(int32_t));
+        } else {
+            base[component.offset] = '\0';
+        }
+    }
+
+    if (field.empty()) {
+        return ParseResult::Empty;
+    }
+
+    ParseResult result = ParseResult::Ok;
+    size_t index = 0;
+    while (index < layout.size()) {
+        const size_t comma = field.find(',');
+        const std::string_view part = field.substr(0, comma);
+        const IsdComponent& component = layout[index++];
+
+        if (component.kind == IsdComponentKind::Value) {
+            int32_t parsed = 0;
+            const ParseResult partResult = FieldParser::parseInt(part, parsed);
+            if (partResult == ParseResult::Ok) {
+                const int32_t stored = parsed == component.missing ? isdMissing : parsed;
+                std::memcpy(base + component.offset, &stored, sizeof(int32_t));
+            } else if (result == ParseResult::Ok) {
+                result = partResult;
+            }
+        } else if (part.size() == 1) {
+            base[component.offset] = part.front();
+        } else if (result == ParseResult::Ok) {
+            result = ParseResult::Invalid;
+        }
+
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        field.remove_prefix(comma + 1);
+    }
+
+    if (index != layout.size() && result == ParseResult::Ok) {
+        result = ParseResult::Invalid;
+    }
+    return result;
+}
+
+/**
+ * @brief Decodes the WND section into direction, speed, and their codes.
+ */
+void IsdDecoder::decodeWind(std::string_view field, IsdWind& wind, ParseErrors& errors) {
+    errors.record(CsvField::Wind, decode(field, windLayout, &wind));
+}
+
+/**
+ * @brief Decodes the CIG section into the ceiling height and its codes.
+ */
+void IsdDecoder::decodeCeiling(std::string_view field, IsdCeiling& ceiling, ParseErrors& errors) {
+    errors.record(CsvField::CloudCeiling, decode(field, ceilingLayout, &ceiling));
+}
+
+/**
+ * @brief Decodes the VIS section into the visibility distance and its codes.
+ */
+void IsdDecoder::decodeVisibility(std::string_view field, IsdVisibility& visibility, ParseErrors& errors) {
+    errors.record(CsvField::VisibilityDistance, decode(field, visibilityLayout, &visibility));
+}
+
+/**
+ * @brief Decodes a TMP or DEW section; `id` tells the error counters which one it was.
+ */
+void IsdDecoder::decodeTemperature(std::string_view field, IsdReading& reading, CsvField id, ParseErrors& errors) {
+    errors.record(id, decode(field, temperatureLayout, &reading));
+}
+
+/**
+ * @brief Decodes the SLP section into the sea level pressure and its quality code.
+ */
+void IsdDecoder::decodePressure(std::string_view field, IsdReading& reading, ParseErrors& errors) {
+    errors.record(CsvField::SeaLevelPressure, decode(field, pressureLayout, &reading));
+}
@@ -0,0 +1,105 @@
+﻿#ifndef ISDDECODER_H
+#define ISDDECODER_H
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+
+#include "FieldParser.h"
+
+/**
+ * @brief Value stored in a decoded numeric component when NOAA marks it as missing.
+ *
+ * The database binds this as NULL, so missing readings never take part in comparisons.
+ */
+constexpr int32_t isdMissing = std::numeric_limits<int32_t>::min();
+
+/**
+ * @struct IsdWind
+ * @brief Decoded WND section: direction in degrees and speed in 0.1 m/s.
+ */
+struct IsdWind {
+    int32_t direction;
+    char directionQuality;
+    char type;
+    int32_t speed;
+    char speedQuality;
+};
+
+/**
+ * @struct IsdCeiling
+ * @brief Decoded CIG section: ceiling height in metres.
+ */
+struct IsdCeiling {
+    int32_t height;
+    char quality;
+    char determination;
+    char cavok;
+};
+
+/**
+ * @struct IsdVisibility
+ * @brief Decoded VIS section: horizontal visibility in metres.
+ */
+struct IsdVisibility {
+    int32_t distance;
+    char quality;
+    char variability;
+    char variabilityQuality;
+};
+
+/**
+ * @struct IsdReading
+ * @brief Decoded single-value section such as TMP and DEW (0.1 °C) or SLP (0.1 hPa).
+ */
+struct IsdReading {
+    int32_t value;
+    char quality;
+};
+
+/**
+ * @enum IsdComponentKind
+ * @brief Whether a section component is a fixed-point number or a one-character code.
+ */
+enum class IsdComponentKind {
+    Value,
+    Code,
+};
+
+/**
+ * @struct IsdComponent
+ * @brief Describes one comma-separated component of an ISD section.
+ *
+ * `offset` locates the member receiving the component inside the decoded struct. For values,
+ * `missing` is the sentinel NOAA writes when the reading is absent, e.g. 9999 for wind speed.
+ */
+struct IsdComponent {
+    IsdComponentKind kind;
+    size_t offset;
+    int32_t missing;
+};
+
+/**
+ * @class IsdDecoder
+ * @brief Decodes the mandatory ISD sections (WND, CIG, VIS, TMP, DEW, SLP) into typed components.
+ *
+ * Each section is described by a layout of `IsdComponent` entries, and a single generic routine
+ * splits the raw field at its commas and stores every component in the member the layout points
+ * to. Numbers keep NOAA's fixed-point scale, so no precision is lost and no floating point is
+ * involved; missing sentinels are replaced by `isdMissing`.
+ */
+class IsdDecoder {
+public:
+    static ParseResult decode(std::string_view field, std::span<const IsdComponent> layout, void* target);
+
+    static void decodeWind(std::string_view field, IsdWind& wind, ParseErrors& errors);
+    static void decodeCeiling(std::string_view field, IsdCeiling& ceiling, ParseErrors& errors);
+    static void decodeVisibility(std::string_view field, IsdVisibility& visibility, ParseErrors& errors);
+    static void decodeTemperature(std::string_view field, IsdReading& reading, CsvField id, ParseErrors& errors);
+    static void decodePressure(std::string_view field, IsdReading& reading, ParseErrors& errors);
+};
+
+
+
+#endif //ISDDECODER_H
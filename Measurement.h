@@ -1,9 +1,14 @@
 ﻿#ifndef MEASUREMENT_H
 #define MEASUREMENT_H
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <ctime>
 #include <vector>
 
+#include "IsdDecoder.h"
+#include "Timestamp.h"
+
 /**
  * @class Measurement
  * @brief Represents a meteorological measurement containing various observations and metrics.
@@ -13,22 +18,25 @@
  * measurement or observation and provides storage for data such as wind, temperature, precipitation,
  * and more.
  *
- * The class includes static functionality to parse data from a CSV-formatted string into a
- * Measurement object.
+ * Rows are parsed into a column-wise `MeasurementBatch` on ingest; a Measurement is what a row
+ * reads back as. `date` is the observation time in seconds since the epoch, see `Timestamp`.
+ * `file` refers to the manifest row of the source file the measurement was loaded from, or is
+ * 0 if it is not known.
  */
 class Measurement {
 public:
     std::string id;
     std::string station;
-    std::string date;
+    int64_t date = timestampMissing;
+    std::string source;
     std::string reportType;
     std::string qualityControlFlag;
-    std::string wind;
-    double cloudCeiling;
-    double visibilityDistance;
-    double temperature;
-    double dewPoints;
-    double seaLevelPressure;
+    IsdWind wind;
+    IsdCeiling cloudCeiling;
+    IsdVisibility visibilityDistance;
+    IsdReading temperature;
+    IsdReading dewPoints;
+    IsdReading seaLevelPressure;
     std::vector<double> hourlyPrecipitation;
     double snowfall;
     double durationOfPrecipitation;
@@ -61,8 +69,8 @@ public:
     std::vector<std::string> errorsOrMissingDataIndicators;
     std::string remarksOrAdditionalNotes;
     std::string equipmentDiagnosticsMetadata;
-
-    static Measurement fromCsv(std::string line);
+    std::string additionalSections;
+    int64_t file = 0;
 };
 
 
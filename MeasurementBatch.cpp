@@ -0,0 +1,160 @@
+﻿#include "MeasurementBatch.h"
+#include <memory>
+
+/**
+ * @brief Replaces this batch, and its arena, with another one.
+ *
+ * The columns of a batch live in its arena, so they cannot be moved into the columns of
+ * another batch one by one. The old batch is destroyed as a whole instead, releasing its arena
+ * in one step, and the other batch is moved in its place.
+ */
+MeasurementBatch& MeasurementBatch::operator=(MeasurementBatch&& other) noexcept {
+    if (this != &other) {
+        std::destroy_at(this);
+        std::construct_at(this, std::move(other));
+    }
+    return *this;
+}
+
+/**
+ * @brief Reserves room for a number of rows in every column and the text buffer.
+ *
+ * Reserving up front lets the arena hand out each column in one piece instead of leaving the
+ * smaller buffers of a growing column behind.
+ *
+ * @param rows The number of rows expected.
+ */
+void MeasurementBatch::reserve(size_t rows) {
+    this->text.reserve(rows * expectedRowBytes);
+    this->station.reserve(rows);
+    this->date.reserve(rows);
+    this->source.reserve(rows);
+    this->reportType.reserve(rows);
+    this->qualityControlFlag.reserve(rows);
+    this->wind.reserve(rows);
+    this->cloudCeiling.reserve(rows);
+    this->visibilityDistance.reserve(rows);
+    this->temperature.reserve(rows);
+    this->dewPoints.reserve(rows);
+    this->seaLevelPressure.reserve(rows);
+    this->additionalSections.reserve(rows);
+    this->file.reserve(rows);
+}
+
+/**
+ * @brief Returns the number of rows in the batch.
+ */
+size_t MeasurementBatch::size() const {
+    return this->station.size();
+}
+
+/**
+ * @brief Returns whether the batch holds no rows.
+ */
+bool MeasurementBatch::empty() const {
+    return this->station.empty();
+}
+
+/**
+ * @brief Appends one row from the fields of a tokenized CSV line, unless the row is unusable.
+ *
+ * The mandatory sections are decoded by `IsdDecoder` straight into their columns, the
+ * observation time is converted to epoch seconds, the categorical fields are replaced by their
+ * dictionary codes, the other stored strings are copied into the text buffer, and the
+ * non-empty additional sections are kept raw by `AdditionalSections::capture`. Families with a
+ * decoder in the plan are decoded as well and stored serialized, ready to be bound. Every
+ * field is taken from the position the file's `ColumnPlan` resolved from its header.
+ *
+ * A row with too few fields, without a station id or without a valid observation time cannot
+ * be stored meaningfully. It is counted in `errors` and not appended, and the failure is
+ * returned so the caller can quarantine the line. A mandatory section that fails to decode only
+ * reads as missing.
+ *
+ * @param fields The tokenized data line.
+ * @param plan The column plan built from the file's header.
+ * @param dictionaries The load's dictionaries of the categorical fields.
+ * @param fileId The manifest id of the file, or 0 if it is not known.
+ * @param errors Per-field conversion failure counters of the file being parsed.
+ * @return The failure the row was rejected for, or nothing if it was appended.
+ */
+std::optional<FieldError> MeasurementBatch::append(const std::vector<std::string_view>& fields, const ColumnPlan& plan, MeasurementDictionaries& dictionaries, int64_t fileId, ParseErrors& errors) {
+    if (fields.size() < plan.width) {
+        errors.record(CsvField::Line, ParseResult::Invalid);
+        return FieldError{CsvField::Line, ParseResult::Invalid};
+    }
+    const std::string_view station = plan.field(fields, CsvColumn::Station);
+    if (station.empty()) {
+        errors.record(CsvField::Station, ParseResult::Empty);
+        return FieldError{CsvField::Station, ParseResult::Empty};
+    }
+
+    int64_t time = timestampMissing;
+    const ParseResult timeResult = Timestamp::parseIso(plan.field(fields, CsvColumn::Date), time, errors);
+    if (timeResult != ParseResult::Ok) {
+        return FieldError{CsvField::Date, timeResult};
+    }
+
+    this->station.push_back(store(station));
+    this->date.push_back(time);
+    this->source.push_back(dictionaries.source.encode(plan.field(fields, CsvColumn::Source), this->lastSource));
+    this->reportType.push_back(dictionaries.reportType.encode(plan.field(fields, CsvColumn::ReportType), this->lastReportType));
+    this->qualityControlFlag.push_back(dictionaries.qualityControlFlag.encode(plan.field(fields, CsvColumn::QualityControl), this->lastQualityControlFlag));
+    IsdDecoder::decodeWind(plan.field(fields, CsvColumn::Wind), this->wind.emplace_back(), errors);
+    IsdDecoder::decodeCeiling(plan.field(fields, CsvColumn::CloudCeiling), this->cloudCeiling.emplace_back(), errors);
+    IsdDecoder::decodeVisibility(plan.field(fields, CsvColumn::Visibility), this->visibilityDistance.emplace_back(), errors);
+    IsdDecoder::decodeTemperature(plan.field(fields, CsvColumn::Temperature), this->temperature.emplace_back(), CsvField::Temperature, errors);
+    IsdDecoder::decodeTemperature(plan.field(fields, CsvColumn::DewPoints), this->dewPoints.emplace_back(), CsvField::DewPoints, errors);
+    IsdDecoder::decodePressure(plan.field(fields, CsvColumn::SeaLevelPressure), this->seaLevelPressure.emplace_back(), errors);
+    const size_t sections = this->text.size();
+    AdditionalSections::capture(fields, plan.sections, this->text, this->scratch, this->used);
+    this->additionalSections.push_back({sections, static_cast<uint32_t>(this->text.size() - sections)});
+    this->text += '\0';
+    this->file.push_back(fileId);
+    storeDecoded();
+    return std::nullopt;
+}
+
+/**
+ * @brief Returns a stored string.
+ */
+std::string_view MeasurementBatch::view(TextRef ref) const {
+    return std::string_view(this->text).substr(ref.offset, ref.length);
+}
+
+/**
+ * @brief Returns a stored string as a NUL-terminated pointer into the text buffer.
+ *
+ * The pointer is valid until the next call to `append`.
+ */
+const char* MeasurementBatch::c_str(TextRef ref) const {
+    return this->text.c_str() + ref.offset;
+}
+
+/**
+ * @brief Copies a string into the text buffer, followed by a NUL terminator.
+ */
+TextRef MeasurementBatch::store(std::string_view value) {
+    const TextRef ref = {this->text.size(), static_cast<uint32_t>(value.size())};
+    this->text += value;
+    this->text += '\0';
+    return ref;
+}
+
+/**
+ * @brief Stores the serialized families decoded for the last row and resets the scratch measurement.
+ */
+void MeasurementBatch::storeDecoded() {
+    if (this->used.empty()) {
+        return;
+    }
+
+    const uint32_t row = static_cast<uint32_t>(size() - 1);
+    const SectionDecoder* first = AdditionalSections::decoders().data();
+    for (const SectionDecoder* decoder : this->used) {
+        const std::string value = decoder->serialize(this->scratch);
+        this->decoded.push_back({row, static_cast<uint32_t>(decoder - first), store(value)});
+    }
+
+    this->used.clear();
+    this->scratch = Measurement();
+}
@@ -0,0 +1,107 @@
+﻿#ifndef MEASUREMENTBATCH_H
+#define MEASUREMENTBATCH_H
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AdditionalSections.h"
+#include "CodeDictionary.h"
+#include "ColumnPlan.h"
+#include "FieldParser.h"
+#include "IsdDecoder.h"
+#include "Measurement.h"
+#include "Timestamp.h"
+
+/**
+ * @struct TextRef
+ * @brief A string stored in the text buffer of a `MeasurementBatch`.
+ */
+struct TextRef {
+    size_t offset = 0;
+    uint32_t length = 0;
+};
+
+/**
+ * @struct DecodedSection
+ * @brief The serialized value of one decoded additional-data family of one row.
+ *
+ * `decoder` is the position of the family in `AdditionalSections::decoders()`.
+ */
+struct DecodedSection {
+    uint32_t row;
+    uint32_t decoder;
+    TextRef value;
+};
+
+/**
+ * @class MeasurementBatch
+ * @brief Column-wise store of the parsed rows handed from the parser to the database writer.
+ *
+ * A `Measurement` carries dozens of strings and vectors, most of them empty, for every row. On
+ * the ingest path only a few of them are filled, so a batch keeps one column per stored field
+ * instead: the decoded mandatory sections as fixed-width structs, the observation time as
+ * epoch seconds, and every string as a `TextRef` into a single shared buffer. The strings are
+ * NUL-terminated in the buffer, so `SQLiteHandler` can bind them without copying. The
+ * categorical fields source, report type and quality control flag are kept as their codes in
+ * the load's `MeasurementDictionaries`. Decoded additional sections are rare and are kept as a
+ * sparse list in row order.
+ *
+ * All columns and the text buffer are allocated from a monotonic arena owned by the batch.
+ * Growing a column never returns memory to the heap; the whole arena is released in one step
+ * when the batch is destroyed or replaced, i.e. once its rows have been committed. Moving a
+ * batch moves its arena along; a moved-from batch must be assigned a new one before use.
+ *
+ * `text` may be reallocated by `append`; `TextRef`s stay valid, pointers into it do not.
+ */
+class MeasurementBatch {
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena = std::make_unique<std::pmr::monotonic_buffer_resource>();
+public:
+    static constexpr size_t expectedRowBytes = 128;
+
+    std::pmr::string text{arena.get()};
+    std::pmr::vector<TextRef> station{arena.get()};
+    std::pmr::vector<int64_t> date{arena.get()};
+    std::pmr::vector<int32_t> source{arena.get()};
+    std::pmr::vector<int32_t> reportType{arena.get()};
+    std::pmr::vector<int32_t> qualityControlFlag{arena.get()};
+    std::pmr::vector<IsdWind> wind{arena.get()};
+    std::pmr::vector<IsdCeiling> cloudCeiling{arena.get()};
+    std::pmr::vector<IsdVisibility> visibilityDistance{arena.get()};
+    std::pmr::vector<IsdReading> temperature{arena.get()};
+    std::pmr::vector<IsdReading> dewPoints{arena.get()};
+    std::pmr::vector<IsdReading> seaLevelPressure{arena.get()};
+    std::pmr::vector<TextRef> additionalSections{arena.get()};
+    std::pmr::vector<int64_t> file{arena.get()};
+    std::pmr::vector<DecodedSection> decoded{arena.get()};
+
+    MeasurementBatch() = default;
+    MeasurementBatch(MeasurementBatch&& other) noexcept = default;
+    MeasurementBatch& operator=(MeasurementBatch&& other) noexcept;
+    MeasurementBatch(const MeasurementBatch&) = delete;
+    MeasurementBatch& operator=(const MeasurementBatch&) = delete;
+
+    void reserve(size_t rows);
+    size_t size() const;
+    bool empty() const;
+    std::optional<FieldError> append(const std::vector<std::string_view>& fields, const ColumnPlan& plan, MeasurementDictionaries& dictionaries, int64_t fileId, ParseErrors& errors);
+    std::string_view view(TextRef ref) const;
+    const char* c_str(TextRef ref) const;
+private:
+    Measurement scratch;
+    CodeDictionary::LastCode lastSource;
+    CodeDictionary::LastCode lastReportType;
+    CodeDictionary::LastCode lastQualityControlFlag;
+    std::vector<const SectionDecoder*> used;
+
+    TextRef store(std::string_view value);
+    void storeDecoded();
+};
+
+
+
+#endif //MEASUREMENTBATCH_H
@@ -0,0 +1,131 @@
+﻿#include "RejectSink.h"
+#include <iostream>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Appends a value to a CSV line, quoted and with embedded quotes doubled.
+ */
+void appendQuoted(std::string& line, std::string_view value) {
+    line += '"';
+    for (const char c : value) {
+        if (c == '"') {
+            line += '"';
+        }
+        line += c;
+    }
+    line += '"';
+}
+
+}
+
+/**
+ * @brief Creates a sink writing to the given path; nothing is created until a row is rejected.
+ *
+ * @param path The rejects CSV file. An existing file is replaced.
+ */
+RejectSink::RejectSink(std::string path) : path(std::move(path)) {
+}
+
+/**
+ * @brief Records the rejected rows of one chunk of a source file.
+ *
+ * @param file The manifest path of the source file.
+ * @param rows The rejected rows, in line order.
+ */
+void RejectSink::add(std::string_view file, const std::vector<RejectedRow>& rows) {
+    if (rows.empty()) {
+        return;
+    }
+
+    auto entry = this->counts.find(file);
+    if (entry == this->counts.end()) {
+        entry = this->counts.emplace(std::string(file), Counts{}).first;
+    }
+
+    for (const RejectedRow& row : rows) {
+        entry->second[static_cast<size_t>(row.reason.field)]++;
+
+        appendQuoted(this->buffer, file);
+        this->buffer += ',';
+        this->buffer += std::to_string(row.line);
+        this->buffer += ',';
+        this->buffer += ParseErrors::fieldName(row.reason.field);
+        this->buffer += " (";
+        this->buffer += ParseErrors::resultName(row.reason.result);
+        this->buffer += "),";
+        appendQuoted(this->buffer, row.text);
+        this->buffer += '\n';
+    }
+
+    if (this->buffer.size() >= flushBytes) {
+        flush();
+    }
+}
+
+/**
+ * @brief Returns the number of rows rejected so far.
+ */
+size_t RejectSink::total() const {
+    size_t total = 0;
+    for (const auto& [file, fields] : this->counts) {
+        for (const size_t count : fields) {
+            total += count;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Writes the collected lines to the rejects file, creating it with its header if needed.
+ */
+void RejectSink::flush() {
+    if (this->buffer.empty()) {
+        return;
+    }
+
+    if (!this->out.is_open()) {
+        this->out.open(this->path, std::ios::binary | std::ios::trunc);
+        if (!this->out) {
+            std::cerr << "Error: Cannot write rejected rows to " << this->path << std::endl;
+            this->buffer.clear();
+            return;
+        }
+        this->out << "file,line,reason,row\n";
+    }
+
+    this->out.write(this->buffer.data(), static_cast<std::streamsize>(this->buffer.size()));
+    this->buffer.clear();
+}
+
+/**
+ * @brief Writes the number of rejected rows per file and field, followed by the total.
+ *
+ * Nothing is written when no row was rejected.
+ *
+ * @param out The stream to write the summary to.
+ */
+void RejectSink::print(std::ostream& out) const {
+    if (this->counts.empty()) {
+        return;
+    }
+
+    out << "Rejected rows (written to " << this->path << "):\n";
+    for (const auto& [file, fields] : this->counts) {
+        out << "  " << file << '\n';
+        for (size_t field = 0; field < fields.size(); ++field) {
+            if (fields[field] > 0) {
+                out << "    " << ParseErrors::fieldName(static_cast<CsvField>(field)) << ": " << fields[field] << '\n';
+            }
+        }
+    }
+    out << "  total: " << total() << '\n';
+}
+
+/**
+ * @brief Writes the rows still collected in memory.
+ */
+RejectSink::~RejectSink() {
+    flush();
+}
@@ -0,0 +1,58 @@
+﻿#ifndef REJECTSINK_H
+#define REJECTSINK_H
+#include <array>
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FieldParser.h"
+
+/**
+ * @struct RejectedRow
+ * @brief A data line kept out of the database, with the field that made it unusable.
+ *
+ * `line` is the 1-based line number within the source file.
+ */
+struct RejectedRow {
+    size_t line;
+    FieldError reason;
+    std::string text;
+};
+
+/**
+ * @class RejectSink
+ * @brief Writes rejected rows to a side CSV file and counts them per source file and field.
+ *
+ * Each rejected row becomes one line "file,line,reason,row" of the rejects file, with the
+ * original line quoted as the last column, so it can be inspected or fixed and loaded again.
+ * Lines are collected in memory and written in large blocks; the file is only created once the
+ * first row is rejected.
+ *
+ * The sink is fed from the writer stage of a load and is not thread-safe.
+ */
+class RejectSink {
+public:
+    static constexpr size_t flushBytes = 1 << 20;
+
+    explicit RejectSink(std::string path);
+    void add(std::string_view file, const std::vector<RejectedRow>& rows);
+    size_t total() const;
+    void flush();
+    void print(std::ostream& out) const;
+    ~RejectSink();
+private:
+    using Counts = std::array<size_t, static_cast<size_t>(CsvField::Count)>;
+
+    std::string path;
+    std::ofstream out;
+    std::string buffer;
+    std::map<std::string, Counts, std::less<>> counts;
+};
+
+
+
+#endif //REJECTSINK_H
@@ -1,8 +1,239 @@
 ﻿#include "SQLiteHandler.h"
 #include <iostream>
 #include <random>
+#include <sqlite3.h>
 #include <windows.h>
 
+namespace {
+
+constexpr const char* measurementColumns = R"(id, station, date, reportType, qualityControlFlag,
+    windDirection, windDirectionQuality, windType, windSpeed, windSpeedQuality,
+    cloudCeiling, cloudCeilingQuality, cloudCeilingDetermination, cavok,
+    visibilityDistance, visibilityDistanceQuality, visibilityVariability, visibilityVariabilityQuality,
+    temperature, temperatureQuality, dewPoints, dewPointsQuality, seaLevelPressure, seaLevelPressureQuality,
+    additionalSections, file, source)";
+
+constexpr const char* measurementPlaceholders = "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?";
+
+constexpr int measurementColumnCount = 27;
+
+/**
+ * @brief The columns of `measurementColumns` as read back, with the dictionary codes resolved
+ *        to their text.
+ */
+constexpr const char* measurementSelectColumns = R"(id, station, date,
+    (SELECT value FROM reportTypes WHERE reportTypes.id = measurements.reportType),
+    (SELECT value FROM qualityControlFlags WHERE qualityControlFlags.id = measurements.qualityControlFlag),
+    windDirection, windDirectionQuality, windType, windSpeed, windSpeedQuality,
+    cloudCeiling, cloudCeilingQuality, cloudCeilingDetermination, cavok,
+    visibilityDistance, visibilityDistanceQuality, visibilityVariability, visibilityVariabilityQuality,
+    temperature, temperatureQuality, dewPoints, dewPointsQuality, seaLevelPressure, seaLevelPressureQuality,
+    additionalSections, file,
+    (SELECT value FROM sources WHERE sources.id = measurements.source))";
+
+void bindText(SQLite::Statement& query, int index, const std::string& text) {
+    if (text.empty()) {
+        query.bind(index);
+    } else {
+        query.bind(index, text);
+    }
+}
+
+void bindValue(SQLite::Statement& query, int index, int32_t value) {
+    if (value == isdMissing) {
+        query.bind(index);
+    } else {
+        query.bind(index, value);
+    }
+}
+
+void bindCode(SQLite::Statement& query, int index, char code) {
+    if (code == '\0') {
+        query.bind(index);
+    } else {
+        query.bind(index, std::string(1, code));
+    }
+}
+
+/**
+ * @brief Binds a time in epoch seconds, or NULL if it is missing.
+ */
+void bindTimestamp(SQLite::Statement& query, int index, int64_t value) {
+    if (value == timestampMissing) {
+        query.bind(index);
+    } else {
+        query.bind(index, value);
+    }
+}
+
+/**
+ * @brief Binds a dictionary code, or NULL for the code 0 of the empty value.
+ */
+void bindDictionaryCode(SQLite::Statement& query, int index, int32_t code) {
+    if (code == 0) {
+        query.bind(index);
+    } else {
+        query.bind(index, code);
+    }
+}
+
+int32_t readValue(const SQLite::Column& column) {
+    return column.isNull() ? isdMissing : column.getInt();
+}
+
+char readCode(const SQLite::Column& column) {
+    return column.isNull() ? '\0' : column.getText()[0];
+}
+
+/**
+ * @brief Binds every stored column of a measurement, in the order of `measurementColumns`.
+ *
+ * The categorical fields are bound as their codes in `dictionaries`.
+ */
+void bindMeasurement(SQLite::Statement& query, const Measurement& measurement, MeasurementDictionaries& dictionaries) {
+    query.bind(1, measurement.id);
+    query.bind(2, measurement.station);
+    bindTimestamp(query, 3, measurement.date);
+    bindDictionaryCode(query, 4, dictionaries.reportType.encode(measurement.reportType));
+    bindDictionaryCode(query, 5, dictionaries.qualityControlFlag.encode(measurement.qualityControlFlag));
+    bindValue(query, 6, measurement.wind.direction);
+    bindCode(query, 7, measurement.wind.directionQuality);
+    bindCode(query, 8, measurement.wind.type);
+    bindValue(query, 9, measurement.wind.speed);
+    bindCode(query, 10, measurement.wind.speedQuality);
+    bindValue(query, 11, measurement.cloudCeiling.height);
+    bindCode(query, 12, measurement.cloudCeiling.quality);
+    bindCode(query, 13, measurement.cloudCeiling.determination);
+    bindCode(query, 14, measurement.cloudCeiling.cavok);
+    bindValue(query, 15, measurement.visibilityDistance.distance);
+    bindCode(query, 16, measurement.visibilityDistance.quality);
+    bindCode(query, 17, measurement.visibilityDistance.variability);
+    bindCode(query, 18, measurement.visibilityDistance.variabilityQuality);
+    bindValue(query, 19, measurement.temperature.value);
+    bindCode(query, 20, measurement.temperature.quality);
+    bindValue(query, 21, measurement.dewPoints.value);
+    bindCode(query, 22, measurement.dewPoints.quality);
+    bindValue(query, 23, measurement.seaLevelPressure.value);
+    bindCode(query, 24, measurement.seaLevelPressure.quality);
+    bindText(query, 25, measurement.additionalSections);
+    if (measurement.file == 0) {
+        query.bind(26);
+    } else {
+        query.bind(26, measurement.file);
+    }
+    bindDictionaryCode(query, 27, dictionaries.source.encode(measurement.source));
+
+    int index = measurementColumnCount;
+    for (const SectionDecoder& decoder : AdditionalSections::decoders()) {
+        bindText(query, ++index, decoder.serialize(measurement));
+    }
+}
+
+/**
+ * @brief Binds a text column of a batch row without copying it, or NULL if it is empty.
+ */
+void bindText(SQLite::Statement& query, int index, const MeasurementBatch& batch, TextRef text) {
+    if (text.length == 0) {
+        query.bind(index);
+    } else {
+        query.bindNoCopy(index, batch.c_str(text));
+    }
+}
+
+/**
+ * @brief Binds every stored column of one batch row, in the order of `measurementColumns`.
+ *
+ * Only the decoded sections are bound for the decoder columns; the others keep the NULL left
+ * by `clearBindings`.
+ *
+ * @param next The position in `batch.decoded` of the row's first decoded section; advanced
+ *             past the row's sections.
+ */
+void bindMeasurement(SQLite::Statement& query, const std::string& id, const MeasurementBatch& batch, size_t row, size_t& next) {
+    query.bind(1, id);
+    query.bindNoCopy(2, batch.c_str(batch.station[row]));
+    bindTimestamp(query, 3, batch.date[row]);
+    bindDictionaryCode(query, 4, batch.reportType[row]);
+    bindDictionaryCode(query, 5, batch.qualityControlFlag[row]);
+    bindValue(query, 6, batch.wind[row].direction);
+    bindCode(query, 7, batch.wind[row].directionQuality);
+    bindCode(query, 8, batch.wind[row].type);
+    bindValue(query, 9, batch.wind[row].speed);
+    bindCode(query, 10, batch.wind[row].speedQuality);
+    bindValue(query, 11, batch.cloudCeiling[row].height);
+    bindCode(query, 12, batch.cloudCeiling[row].quality);
+    bindCode(query, 13, batch.cloudCeiling[row].determination);
+    bindCode(query, 14, batch.cloudCeiling[row].cavok);
+    bindValue(query, 15, batch.visibilityDistance[row].distance);
+    bindCode(query, 16, batch.visibilityDistance[row].quality);
+    bindCode(query, 17, batch.visibilityDistance[row].variability);
+    bindCode(query, 18, batch.visibilityDistance[row].variabilityQuality);
+    bindValue(query, 19, batch.temperature[row].value);
+    bindCode(query, 20, batch.temperature[row].quality);
+    bindValue(query, 21, batch.dewPoints[row].value);
+    bindCode(query, 22, batch.dewPoints[row].quality);
+    bindValue(query, 23, batch.seaLevelPressure[row].value);
+    bindCode(query, 24, batch.seaLevelPressure[row].quality);
+    bindText(query, 25, batch, batch.additionalSections[row]);
+    if (batch.file[row] == 0) {
+        query.bind(26);
+    } else {
+        query.bind(26, batch.file[row]);
+    }
+    bindDictionaryCode(query, 27, batch.source[row]);
+
+    for (; next < batch.decoded.size() && batch.decoded[next].row == row; ++next) {
+        const DecodedSection& section = batch.decoded[next];
+        bindText(query, measurementColumnCount + 1 + static_cast<int>(section.decoder), batch, section.value);
+    }
+}
+
+const std::vector<const SectionDecoder*>& allSections() {
+    static const std::vector<const SectionDecoder*> sections = AdditionalSections::select({"all"});
+    return sections;
+}
+
+/**
+ * @brief Reads a measurement from a row selected with `measurementSelectColumns`.
+ *
+ * The additional sections are decoded from their raw text, so every decodable family is
+ * available on measurements read back, whether or not it was decoded at ingest.
+ */
+Measurement readMeasurement(const SQLite::Statement& query) {
+    Measurement measurement = {};
+    measurement.id = query.getColumn(0).getText();
+    measurement.station = query.getColumn(1).getText();
+    measurement.date = query.getColumn(2).isNull() ? timestampMissing : query.getColumn(2).getInt64();
+    measurement.reportType = query.getColumn(3).getText();
+    measurement.qualityControlFlag = query.getColumn(4).getText();
+    measurement.wind.direction = readValue(query.getColumn(5));
+    measurement.wind.directionQuality = readCode(query.getColumn(6));
+    measurement.wind.type = readCode(query.getColumn(7));
+    measurement.wind.speed = readValue(query.getColumn(8));
+    measurement.wind.speedQuality = readCode(query.getColumn(9));
+    measurement.cloudCeiling.height = readValue(query.getColumn(10));
+    measurement.cloudCeiling.quality = readCode(query.getColumn(11));
+    measurement.cloudCeiling.determination = readCode(query.getColumn(12));
+    measurement.cloudCeiling.cavok = readCode(query.getColumn(13));
+    measurement.visibilityDistance.distance = readValue(query.getColumn(14));
+    measurement.visibilityDistance.quality = readCode(query.getColumn(15));
+    measurement.visibilityDistance.variability = readCode(query.getColumn(16));
+    measurement.visibilityDistance.variabilityQuality = readCode(query.getColumn(17));
+    measurement.temperature.value = readValue(query.getColumn(18));
+    measurement.temperature.quality = readCode(query.getColumn(19));
+    measurement.dewPoints.value = readValue(query.getColumn(20));
+    measurement.dewPoints.quality = readCode(query.getColumn(21));
+    measurement.seaLevelPressure.value = readValue(query.getColumn(22));
+    measurement.seaLevelPressure.quality = readCode(query.getColumn(23));
+    measurement.additionalSections = query.getColumn(24).getText();
+    measurement.file = query.getColumn(25).getInt64();
+    measurement.source = query.getColumn(26).getText();
+    AdditionalSections::decode(measurement.additionalSections, allSections(), measurement);
+    return measurement;
+}
+
+}
+
 /**
  * @class SQLiteHandler
  * @brief Handles the initialization and management of an SQLite database connection.
@@ -26,6 +257,9 @@
  */
 SQLiteHandler::SQLiteHandler(const std::string& database): db(database, SQLite::OPEN_READWRITE|SQLite::OPEN_CREATE) {
     this->database = database;
+    std::random_device seed;
+    std::seed_seq sequence{seed(), seed(), seed(), seed(), seed(), seed(), seed(), seed()};
+    this->idGenerator.seed(sequence);
 }
 
 /**
@@ -42,7 +276,24 @@ SQLiteHandler::SQLiteHandler(const std::string& database): db(database, SQLite::
  * The "measurements" table is a comprehensive schema for recording meteorological and related
  * data, including temperature, wind, precipitation metrics, weather conditions, and other observations.
  * It supports a variety of data types and structured fields such as comma-separated values for
- * additional details.
+ * additional details. The mandatory NOAA sections are stored decoded: every value is an INTEGER
+ * column in NOAA's fixed-point scale (NULL when missing) next to one-character TEXT columns for
+ * its quality and type codes.
+ *
+ * The categorical fields source, report type and quality control flag take only a few dozen
+ * distinct values. The "sources", "reportTypes" and "qualityControlFlags" dictionary tables map
+ * each value to a small integer code, and measurements store the code, NULL for an empty
+ * value. Filtering on them compares integers, e.g.
+ * `reportType = (SELECT id FROM reportTypes WHERE value = 'FM-15')`. The stored codes are
+ * loaded into the handler's dictionaries, so an appending load keeps using them.
+ *
+ * The observation time is stored as an INTEGER of seconds since the epoch, so time ranges and
+ * buckets such as `date / 3600` compare and group integers. `executeQuery` formats the plain
+ * column as ISO text again.
+ *
+ * The "files" table is the manifest of loaded source files with their size, modification time
+ * and content hash. Each measurement refers to the manifest row of the file it came from, so the
+ * rows of a changed file can be replaced on an incremental load.
  *
  * Error handling: Any exception thrown by SQLite operations is caught and logged, ensuring that
  * application initialization does not abruptly terminate. Errors are output to the standard error stream.
@@ -71,21 +322,35 @@ void SQLiteHandler::init() {
                 CREATE TABLE IF NOT EXISTS measurements (
                     id TEXT PRIMARY KEY,
                     station TEXT,
-                    date TEXT,
-                    reportType TEXT,
-                    qualityControlFlag TEXT,
-                    wind TEXT,
-                    cloudCeiling REAL,
-                    visibilityDistance REAL,
-                    temperature REAL,
-                    dewPoints REAL,
-                    seaLevelPressure REAL,
+                    date INTEGER,  -- Seconds since 1970-01-01T00:00:00 UTC
+                    source INTEGER,  -- Code in the sources table
+                    reportType INTEGER,  -- Code in the reportTypes table
+                    qualityControlFlag INTEGER,  -- Code in the qualityControlFlags table
+                    windDirection INTEGER,  -- Degrees
+                    windDirectionQuality TEXT,
+                    windType TEXT,
+                    windSpeed INTEGER,  -- 0.1 m/s
+                    windSpeedQuality TEXT,
+                    cloudCeiling INTEGER,  -- Metres
+                    cloudCeilingQuality TEXT,
+                    cloudCeilingDetermination TEXT,
+                    cavok TEXT,
+                    visibilityDistance INTEGER,  -- Metres
+                    visibilityDistanceQuality TEXT,
+                    visibilityVariability TEXT,
+                    visibilityVariabilityQuality TEXT,
+                    temperature INTEGER,  -- 0.1 degrees Celsius
+                    temperatureQuality TEXT,
+                    dewPoints INTEGER,  -- 0.1 degrees Celsius
+                    dewPointsQuality TEXT,
+                    seaLevelPressure INTEGER,  -- 0.1 hPa
+                    seaLevelPressureQuality TEXT,
                     hourlyPrecipitation TEXT,  -- Comma-separated list of doubles
                     snowfall REAL,
                     durationOfPrecipitation REAL,
                     weatherPhenomena TEXT,
-                    skyCover TEXT,  -- Comma-separated list of strings
-                    atmosphericParameters TEXT,  -- Comma-separated list of strings
+                    skyCover TEXT,  -- Semicolon-separated list of strings
+                    atmosphericParameters TEXT,  -- Semicolon-separated list of strings
                     freezingRainObservations TEXT,
                     lightningActivity TEXT,
                     atmosphericPressureTendency TEXT,
@@ -99,8 +364,8 @@ void SQLiteHandler::init() {
                     iceObservations TEXT,
                     groundFrostObservations TEXT,
                     SolarOrAtmosphericRadiationDetails TEXT,
-                    temperatureExtremes TEXT,  -- Comma-separated list of strings
-                    extremeWindConditions TEXT,  -- Comma-separated list of strings
+                    temperatureExtremes TEXT,  -- Semicolon-separated list of strings
+                    extremeWindConditions TEXT,  -- Semicolon-separated list of strings
                     condensationMeasurements TEXT,
                     soilMoisture TEXT,
                     soilTemperature TEXT,
@@ -111,8 +376,34 @@ void SQLiteHandler::init() {
                     observationConditionFlags TEXT,
                     errorsOrMissingDataIndicators TEXT,  -- Comma-separated list of strings
                     remarksOrAdditionalNotes TEXT,
-                    equipmentDiagnosticsMetadata TEXT
+                    equipmentDiagnosticsMetadata TEXT,
+                    additionalSections TEXT,  -- Raw optional sections as tab-separated code and value pairs
+                    file INTEGER  -- Row of the source file in the files table
                 );
+                CREATE INDEX IF NOT EXISTS measurementsFile ON measurements (file);
+        )");
+    }catch (const SQLite::Exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+
+    try {
+        for (const auto& [table, dictionary] : dictionaryTables()) {
+            db.exec(std::string("CREATE TABLE IF NOT EXISTS ") + table + " (id INTEGER PRIMARY KEY, value TEXT UNIQUE);");
+        }
+        loadDictionaries();
+    }catch (const SQLite::Exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+
+    try {
+        db.exec(R"(
+            CREATE TABLE IF NOT EXISTS files (
+                id INTEGER PRIMARY KEY,
+                path TEXT UNIQUE,
+                size INTEGER,
+                mtime INTEGER,
+                hash TEXT  -- NULL until the file has been loaded completely
+            );
         )");
     }catch (const SQLite::Exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -143,22 +434,12 @@ void SQLiteHandler::init() {
  *         is found, the returned object may contain default or empty fields.
  */
 Measurement SQLiteHandler::getMeasurement(const std::string &measurementId) const {
-    SQLite::Statement query(db,"SELECT id, station, date, reportType, qualityControlFlag, wind, cloudCeiling, visibilityDistance, temperature, dewPoints, seaLevelPressure FROM measurements WHERE id = ?;");
+    SQLite::Statement query(db, std::string("SELECT ") + measurementSelectColumns + " FROM measurements WHERE id = ?;");
     query.bind(1, measurementId);
     auto measurement = Measurement();
 
     while (query.executeStep()) {
-        measurement.id = query.getColumn(0).getText();
-        measurement.station = query.getColumn(1).getText();
-        measurement.date = query.getColumn(2).getText();
-        measurement.reportType = query.getColumn(3).getText();
-        measurement.qualityControlFlag = query.getColumn(4).getText();
-        measurement.wind = query.getColumn(5).getText();
-        measurement.cloudCeiling = query.getColumn(6).getDouble();
-        measurement.visibilityDistance = query.getColumn(7).getDouble();
-        measurement.temperature = query.getColumn(8).getDouble();
-        measurement.dewPoints = query.getColumn(9).getDouble();
-        measurement.seaLevelPressure = query.getColumn(10).getDouble();
+        measurement = readMeasurement(query);
     }
 
     return measurement;
@@ -212,12 +493,12 @@ Station SQLiteHandler::getStation(const std::string &stationId) const {
  * - date
  * - reportType
  * - qualityControlFlag
- * - wind
- * - cloudCeiling
- * - visibilityDistance
- * - temperature
- * - dewPoints
- * - seaLevelPressure
+ * - wind direction, speed and their codes
+ * - cloudCeiling and its codes
+ * - visibilityDistance and its codes
+ * - temperature and its quality code
+ * - dewPoints and its quality code
+ * - seaLevelPressure and its quality code
  *
  * The database operation is performed through a parameterized query to ensure data
  * integrity and prevent SQL injection.
@@ -230,20 +511,10 @@ Station SQLiteHandler::getStation(const std::string &stationId) const {
 Measurement & SQLiteHandler::insertMeasurement(Measurement &measurement) const {
     measurement.id = generateUniqueId("measurements");
 
-    SQLite::Statement query(db, R"(INSERT INTO measurements (id, station, date, reportType, qualityControlFlag, wind, cloudCeiling, visibilityDistance, temperature, dewPoints, seaLevelPressure)
-                                   VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?))");
+    SQLite::Statement query(db, insertMeasurementSql());
 
-    query.bind(1, measurement.id);
-    query.bind(2, measurement.station);
-    query.bind(3, measurement.date);
-    query.bind(4, measurement.reportType);
-    query.bind(5, measurement.qualityControlFlag);
-    query.bind(6, measurement.wind);
-    query.bind(7, measurement.cloudCeiling);
-    query.bind(8, measurement.visibilityDistance);
-    query.bind(9, measurement.temperature);
-    query.bind(10, measurement.dewPoints);
-    query.bind(11, measurement.seaLevelPressure);
+    bindMeasurement(query, measurement, this->dictionaries);
+    storeDictionaries();
 
     query.exec();
     return measurement;
@@ -252,8 +523,8 @@ Measurement & SQLiteHandler::insertMeasurement(Measurement &measurement) const {
 /**
  * @brief Inserts a list of measurements into the SQLite database.
  *
- * This method iterates through the provided list of measurements, generates a unique ID
- * for each measurement entry, and inserts the corresponding data into the `measurements`
+ * This method iterates through the provided list of measurements, draws a random ID
+ * for each measurement entry as `insertRow` does, and inserts the corresponding data into the `measurements`
  * table in the SQLite database. The function utilizes prepared statements for batching
  * the insert operations efficiently.
  *
@@ -267,28 +538,68 @@ Measurement & SQLiteHandler::insertMeasurement(Measurement &measurement) const {
  *                              will have its unique ID assigned during insertion.
  */
 void SQLiteHandler::insertMeasurements(std::vector<Measurement> &measurements) const {
-    SQLite::Statement query(db, R"(INSERT INTO measurements (id, station, date, reportType, qualityControlFlag, wind, cloudCeiling, visibilityDistance, temperature, dewPoints, seaLevelPressure)
-                                   VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?))");
+    SQLite::Statement query(db, insertMeasurementSql());
     for (Measurement &measurement : measurements) {
-        measurement.id = generateUniqueId("measurements");
-
-        query.bind(1, measurement.id);
-        query.bind(2, measurement.station);
-        query.bind(3, measurement.date);
-        query.bind(4, measurement.reportType);
-        query.bind(5, measurement.qualityControlFlag);
-        query.bind(6, measurement.wind);
-        query.bind(7, measurement.cloudCeiling);
-        query.bind(8, measurement.visibilityDistance);
-        query.bind(9, measurement.temperature);
-        query.bind(10, measurement.dewPoints);
-        query.bind(11, measurement.seaLevelPressure);
+        measurement.id = generateId(32);
+
+        bindMeasurement(query, measurement, this->dictionaries);
+        storeDictionaries();
         query.exec();
         query.clearBindings();
         query.reset();
     }
 }
 
+/**
+ * @brief Inserts the rows of a column-wise batch into the SQLite database.
+ *
+ * Works like the `Measurement` overload, but binds straight from the batch's columns: strings
+ * are bound as pointers into its text buffer without being copied, and only the decoded
+ * sections a row actually has are bound. The dictionary codes the batch's parser assigned are
+ * stored along with the rows.
+ *
+ * The rows become part of the caller's transaction, if one is open. To write many batches in
+ * transactions of a fixed size, use a `BulkWriter`.
+ *
+ * Thread-safety: This method is not thread-safe. Proper synchronization is required when
+ * accessed from multiple threads.
+ *
+ * Exception safety: Throws exceptions if there are issues with database connectivity, invalid SQL,
+ * or binding errors. Exception handling must be implemented by the caller.
+ *
+ * @param[in] measurements The batch of parsed rows to insert.
+ */
+void SQLiteHandler::insertMeasurements(const MeasurementBatch &measurements) const {
+    storeDictionaries();
+    SQLite::Statement query(db, insertMeasurementSql());
+    size_t next = 0;
+    for (size_t row = 0; row < measurements.size(); ++row) {
+        insertRow(query, measurements, row, next);
+    }
+}
+
+/**
+ * @brief Inserts one row of a batch with a prepared statement, which is reset afterwards.
+ *
+ * The row's id is drawn from the handler's generator without looking it up first: 32
+ * alphanumeric characters make a collision practically impossible, and the primary key would
+ * reject one, failing the row like any other constraint violation.
+ *
+ * @param query The prepared `insertMeasurementSql`.
+ * @param batch The batch holding the row.
+ * @param row The index of the row in the batch.
+ * @param next The position in `batch.decoded` of the row's first decoded section; advanced
+ *             past the row's sections.
+ */
+void SQLiteHandler::insertRow(SQLite::Statement& query, const MeasurementBatch& batch, size_t row, size_t& next) const {
+    const std::string id = generateId(32);
+
+    bindMeasurement(query, id, batch, row, next);
+    query.exec();
+    query.clearBindings();
+    query.reset();
+}
+
 /**
  * @brief Inserts a station record into the SQLite database.
  *
@@ -315,8 +626,7 @@ void SQLiteHandler::insertMeasurements(std::vector<Measurement> &measurements) c
  * @return A reference to the input Station object.
  */
 Station & SQLiteHandler::insertStation(Station &station) const {
-    SQLite::Statement query(db, R"(INSERT INTO stations (id, name, longitude, latitude, elevation, callSign)
-                                   VALUES (?, ?, ?, ?, ?, ?))");
+    SQLite::Statement query(db, insertStationSql());
 
     query.bind(1, station.id);
     query.bind(2, station.name);
@@ -344,21 +654,27 @@ Station & SQLiteHandler::insertStation(Station &station) const {
  *                         The objects in the vector can be modified during the process, if needed.
  */
 void SQLiteHandler::insertStations(std::vector<Station> &stations) const {
-    SQLite::Statement query(db, R"(INSERT INTO stations (id, name, longitude, latitude, elevation, callSign)
-                                   VALUES (?, ?, ?, ?, ?, ?))");
-    for (Station &station : stations) {
-        query.bind(1, station.id);
-        query.bind(2, station.name);
-        query.bind(3, station.longitude);
-        query.bind(4, station.latitude);
-        query.bind(5, station.elevation);
-        query.bind(6, station.callSign);
-        query.exec();
-        query.clearBindings();
-        query.reset();
+    SQLite::Statement query(db, insertStationSql());
+    for (const Station &station : stations) {
+        insertRow(query, station);
     }
 }
 
+/**
+ * @brief Inserts one station with a prepared `insertStationSql`, which is reset afterwards.
+ */
+void SQLiteHandler::insertRow(SQLite::Statement& query, const Station& station) const {
+    query.bind(1, station.id);
+    query.bind(2, station.name);
+    query.bind(3, station.longitude);
+    query.bind(4, station.latitude);
+    query.bind(5, station.elevation);
+    query.bind(6, station.callSign);
+    query.exec();
+    query.clearBindings();
+    query.reset();
+}
+
 /**
  * @brief Updates an existing measurement record in the SQLite database.
  *
@@ -442,8 +758,10 @@ bool SQLiteHandler::deleteStation(Station &station) {
 /**
  * @brief Cleans the SQLite database by dropping specific tables.
  *
- * The cleanDatabase method removes tables 'measurements' and 'stations'
- * from the connected SQLite database. This operation is irreversible
+ * The cleanDatabase method removes tables 'measurements', 'stations',
+ * the 'files' manifest and the dictionary tables from the connected
+ * SQLite database, and forgets the dictionary codes. Tables that do
+ * not exist yet are skipped. This operation is irreversible
  * and should be used with caution, as it deletes all data within
  * these tables.
  *
@@ -460,8 +778,13 @@ bool SQLiteHandler::deleteStation(Station &station) {
  */
 bool SQLiteHandler::cleanDatabase() {
     try {
-        db.exec("DROP TABLE measurements;");
-        db.exec("DROP TABLE stations;");
+        db.exec("DROP TABLE IF EXISTS measurements;");
+        db.exec("DROP TABLE IF EXISTS stations;");
+        db.exec("DROP TABLE IF EXISTS files;");
+        for (const auto& [table, dictionary] : dictionaryTables()) {
+            db.exec(std::string("DROP TABLE IF EXISTS ") + table + ";");
+            dictionary->clear();
+        }
         return true;
     }catch (SQLite::Exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -481,23 +804,11 @@ bool SQLiteHandler::cleanDatabase() {
  *         If the table is empty, returns an empty vector.
  */
 std::vector<Measurement> SQLiteHandler::getAllMeasurements() const {
-    SQLite::Statement query(db, "SELECT * FROM measurements;");
+    SQLite::Statement query(db, std::string("SELECT ") + measurementSelectColumns + " FROM measurements;");
     std::vector<Measurement> measurements;
 
     while (query.executeStep()) {
-        Measurement measurement;
-        measurement.id = query.getColumn(0).getText();
-        measurement.station = query.getColumn(1).getText();
-        measurement.date = query.getColumn(2).getText();
-        measurement.reportType = query.getColumn(3).getText();
-        measurement.qualityControlFlag = query.getColumn(4).getText();
-        measurement.wind = query.getColumn(5).getText();
-        measurement.cloudCeiling = query.getColumn(6).getDouble();
-        measurement.visibilityDistance = query.getColumn(7).getDouble();
-        measurement.temperature = query.getColumn(8).getDouble();
-        measurement.dewPoints = query.getColumn(9).getDouble();
-        measurement.seaLevelPressure = query.getColumn(10).getDouble();
-        measurements.push_back(measurement);
+        measurements.push_back(readMeasurement(query));
     }
 
     return measurements;
@@ -575,6 +886,240 @@ int SQLiteHandler::countStations() const {
     return query.getColumn(0).getInt();
 }
 
+/**
+ * @brief Decodes additional sections of already stored measurements from their raw text.
+ *
+ * Measurements keep their optional NOAA sections verbatim in the `additionalSections` column.
+ * This method decodes the given section families from that text and writes the results into
+ * their columns, so sections skipped at ingest can be made queryable later without reloading
+ * the source files.
+ *
+ * Rows are processed in rowid order in slices of 10,000, all inside one transaction, so the
+ * update is atomic and memory use does not grow with the size of the table.
+ *
+ * Exception safety: Throws SQLite exceptions on database errors; the transaction is then
+ * rolled back and no row is changed.
+ *
+ * @param[in] sections The section decoders to run, as returned by `AdditionalSections::select`.
+ * @return The number of measurements that were updated.
+ */
+int SQLiteHandler::backfillSections(const std::vector<const SectionDecoder*>& sections) {
+    if (sections.empty()) {
+        return 0;
+    }
+
+    std::string assignments;
+    for (const SectionDecoder* decoder : sections) {
+        if (!assignments.empty()) {
+            assignments += ", ";
+        }
+        assignments += std::string(decoder->column) + " = ?";
+    }
+
+    SQLite::Transaction transaction(db);
+    SQLite::Statement select(db, "SELECT rowid, additionalSections FROM measurements WHERE rowid > ? AND additionalSections IS NOT NULL ORDER BY rowid LIMIT 10000;");
+    SQLite::Statement update(db, "UPDATE measurements SET " + assignments + " WHERE rowid = ?;");
+
+    int updated = 0;
+    long long lastRowId = 0;
+    std::vector<std::pair<long long, std::string>> slice;
+
+    do {
+        slice.clear();
+        select.bind(1, lastRowId);
+        while (select.executeStep()) {
+            slice.emplace_back(select.getColumn(0).getInt64(), select.getColumn(1).getText());
+        }
+        select.reset();
+
+        for (const auto& [rowId, raw] : slice) {
+            Measurement measurement = {};
+            AdditionalSections::decode(raw, sections, measurement);
+
+            int index = 0;
+            for (const SectionDecoder* decoder : sections) {
+                bindText(update, ++index, decoder->serialize(measurement));
+            }
+            update.bind(++index, rowId);
+            update.exec();
+            update.reset();
+
+            lastRowId = rowId;
+            updated++;
+        }
+    } while (!slice.empty());
+
+    transaction.commit();
+    return updated;
+}
+
+/**
+ * @brief Reads the manifest of source files loaded into the database.
+ *
+ * @return Every manifest row, keyed by file path. Files whose load never completed have an
+ *         empty hash.
+ */
+std::map<std::string, ManifestEntry> SQLiteHandler::getManifest() const {
+    SQLite::Statement query(db, "SELECT id, path, size, mtime, hash FROM files;");
+    std::map<std::string, ManifestEntry> manifest;
+
+    while (query.executeStep()) {
+        ManifestEntry entry;
+        entry.id = query.getColumn(0).getInt64();
+        entry.path = query.getColumn(1).getText();
+        entry.size = query.getColumn(2).getInt64();
+        entry.mtime = query.getColumn(3).getInt64();
+        entry.hash = query.getColumn(4).getText();
+        manifest.emplace(entry.path, entry);
+    }
+
+    return manifest;
+}
+
+/**
+ * @brief Records a source file in the manifest before its rows are inserted.
+ *
+ * The hash is stored as NULL until `updateManifestEntry` marks the file as completely loaded.
+ *
+ * @param[in] entry The file to record. A non-zero `id` is used as the row's id, for callers
+ *                  that assign ids ahead of the insert; with 0 SQLite assigns one.
+ * @return The id of the new manifest row, referenced by the file's measurements.
+ */
+int64_t SQLiteHandler::insertManifestEntry(const ManifestEntry& entry) const {
+    SQLite::Statement query(db, "INSERT INTO files (id, path, size, mtime, hash) VALUES (?, ?, ?, ?, ?);");
+    if (entry.id == 0) {
+        query.bind(1);
+    } else {
+        query.bind(1, entry.id);
+    }
+    query.bind(2, entry.path);
+    query.bind(3, entry.size);
+    query.bind(4, entry.mtime);
+    bindText(query, 5, entry.hash);
+    query.exec();
+    return db.getLastInsertRowid();
+}
+
+/**
+ * @brief Stores the size, modification time and hash of a file already in the manifest.
+ *
+ * @param[in] entry The file to update, identified by its `id`. An empty hash is stored as NULL.
+ */
+void SQLiteHandler::updateManifestEntry(const ManifestEntry& entry) const {
+    SQLite::Statement query(db, "UPDATE files SET size = ?, mtime = ?, hash = ? WHERE id = ?;");
+    query.bind(1, entry.size);
+    query.bind(2, entry.mtime);
+    bindText(query, 3, entry.hash);
+    query.bind(4, entry.id);
+    query.exec();
+}
+
+/**
+ * @brief Deletes every measurement loaded from a source file, before the file is loaded again.
+ *
+ * @param[in] file The manifest id of the file.
+ * @return The number of deleted measurements.
+ */
+int SQLiteHandler::deleteMeasurementsOfFile(int64_t file) const {
+    SQLite::Statement query(db, "DELETE FROM measurements WHERE file = ?;");
+    query.bind(1, file);
+    return query.exec();
+}
+
+/**
+ * @brief Returns the dictionaries of the categorical measurement fields.
+ *
+ * Parsers encode rows with them while loading; codes they assign are stored by the next
+ * `insertMeasurements` call.
+ */
+MeasurementDictionaries& SQLiteHandler::getDictionaries() {
+    return this->dictionaries;
+}
+
+/**
+ * @brief Pairs every dictionary table with the in-memory dictionary of its field.
+ */
+std::array<std::pair<const char*, CodeDictionary*>, 3> SQLiteHandler::dictionaryTables() const {
+    return {{
+        {"sources", &this->dictionaries.source},
+        {"reportTypes", &this->dictionaries.reportType},
+        {"qualityControlFlags", &this->dictionaries.qualityControlFlag},
+    }};
+}
+
+/**
+ * @brief Registers the codes stored in the dictionary tables with the in-memory dictionaries.
+ */
+void SQLiteHandler::loadDictionaries() {
+    for (const auto& [table, dictionary] : dictionaryTables()) {
+        SQLite::Statement query(db, std::string("SELECT id, value FROM ") + table + ";");
+        while (query.executeStep()) {
+            dictionary->add(query.getColumn(0).getInt(), query.getColumn(1).getText());
+        }
+    }
+}
+
+/**
+ * @brief Stores the dictionary codes assigned since the last call in their tables.
+ *
+ * Called before the rows that use the codes are inserted, so both are part of the same
+ * transaction. Codes handed over again after a rollback may be stored already and are
+ * ignored then.
+ */
+void SQLiteHandler::storeDictionaries() const {
+    for (const auto& [table, dictionary] : dictionaryTables()) {
+        const std::vector<std::pair<int32_t, std::string>> added = dictionary->takeAdded();
+        if (added.empty()) {
+            continue;
+        }
+
+        SQLite::Statement query(db, std::string("INSERT OR IGNORE INTO ") + table + " (id, value) VALUES (?, ?);");
+        for (const auto& [code, value] : added) {
+            query.bind(1, code);
+            query.bind(2, value);
+            query.exec();
+            query.reset();
+        }
+    }
+}
+
+/**
+ * @brief Starts a transaction that spans the following inserts and updates.
+ *
+ * The loader keeps a transaction open while it writes and commits it whenever a file is
+ * complete, so every commit is a durable checkpoint: either a file and its manifest hash are
+ * stored together, or the file is still marked incomplete and is loaded again on resume.
+ * An open transaction is rolled back when the connection is closed.
+ */
+void SQLiteHandler::beginTransaction() {
+    db.exec("BEGIN;");
+}
+
+/**
+ * @brief Commits the transaction started by `beginTransaction`.
+ */
+void SQLiteHandler::commitTransaction() {
+    db.exec("COMMIT;");
+}
+
+/**
+ * @brief Discards the transaction started by `beginTransaction`.
+ *
+ * After some errors, e.g. SQLITE_FULL or SQLITE_IOERR, SQLite has already rolled the
+ * transaction back itself; then there is nothing left to roll back. Either way the in-memory
+ * dictionaries keep the codes assigned while the transaction was open, so every code is
+ * handed to the next `storeDictionaries` again; rows written later may use them.
+ */
+void SQLiteHandler::rollbackTransaction() {
+    for (const auto& [table, dictionary] : dictionaryTables()) {
+        dictionary->restoreAdded();
+    }
+
+    if (!sqlite3_get_autocommit(db.getHandle())) {
+        db.exec("ROLLBACK;");
+    }
+}
+
 /**
  * @brief Destructor for the SQLiteHandler class.
  *
@@ -594,14 +1139,39 @@ SQLiteHandler::~SQLiteHandler() {
     db = nullptr;
 }
 
+/**
+ * @brief Runs an SQL query and returns every result row as column name and text pairs.
+ *
+ * A result column that is the `date` column of a table, declared INTEGER, holds epoch seconds
+ * and is returned as ISO text. Expressions have no declared type, so e.g. `date / 3600 AS date`
+ * is returned as the number it computes.
+ *
+ * @param[in] query The SQL query to run.
+ * @return The result rows.
+ */
 std::vector<std::map<std::string, std::string>> SQLiteHandler::executeQuery(const std::string &query) {
     SQLite::Statement statement(db, query);
     std::vector<std::map<std::string, std::string>> values;
 
+    std::vector<bool> dates(statement.getColumnCount());
+    for (int i = 0; i < statement.getColumnCount(); ++i) {
+        try {
+            dates[i] = std::string_view(statement.getColumnName(i)) == "date"
+                && std::string_view(statement.getColumnDeclaredType(i)) == "INTEGER";
+        } catch (const SQLite::Exception&) {
+            // Thrown for an expression, which has no declared type
+        }
+    }
+
     while (statement.executeStep()) {
         std::map<std::string, std::string> row;
         for (int i = 0; i < statement.getColumnCount(); ++i) {
-            row[statement.getColumnName(i)] = statement.getColumn(i).getText();
+            const SQLite::Column column = statement.getColumn(i);
+            if (dates[i] && column.isInteger()) {
+                row[statement.getColumnName(i)] = Timestamp::formatIso(column.getInt64());
+            } else {
+                row[statement.getColumnName(i)] = column.getText();
+            }
         }
         values.push_back(row);
     }
@@ -623,16 +1193,47 @@ std::vector<std::map<std::string, std::string>> SQLiteHandler::executeQuery(cons
  * @return A unique 32-character identifier that does not exist in the specified table.
  */
 std::string SQLiteHandler::generateUniqueId(const std::string &table) const {
+    SQLite::Statement checkQuery(db, idCheckSql(table));
     while (true) {
         std::string randomId = generateId(32);
-        SQLite::Statement checkQuery(db, "SELECT COUNT(*) FROM " + table + " WHERE id = ?");
         checkQuery.bind(1, randomId);
-        if (checkQuery.executeStep() && checkQuery.getColumn(0).getInt() == 0) {
+        const bool unique = checkQuery.executeStep() && checkQuery.getColumn(0).getInt() == 0;
+        checkQuery.reset();
+        if (unique) {
             return randomId;
         }
     }
 }
 
+/**
+ * @brief Builds the measurement INSERT, including one column per additional-section decoder.
+ */
+std::string SQLiteHandler::insertMeasurementSql() {
+    std::string columns = measurementColumns;
+    std::string placeholders = measurementPlaceholders;
+    for (const SectionDecoder& decoder : AdditionalSections::decoders()) {
+        columns += ", ";
+        columns += decoder.column;
+        placeholders += ", ?";
+    }
+    return "INSERT INTO measurements (" + columns + ") VALUES (" + placeholders + ")";
+}
+
+/**
+ * @brief Returns the station INSERT.
+ */
+std::string SQLiteHandler::insertStationSql() {
+    return R"(INSERT INTO stations (id, name, longitude, latitude, elevation, callSign)
+              VALUES (?, ?, ?, ?, ?, ?))";
+}
+
+/**
+ * @brief Returns the query counting the rows of a table with a given id.
+ */
+std::string SQLiteHandler::idCheckSql(const std::string &table) {
+    return "SELECT COUNT(*) FROM " + table + " WHERE id = ?";
+}
+
 /**
  * @brief Generates a random alphanumeric string of the specified length.
  *
@@ -640,8 +1241,10 @@ std::string SQLiteHandler::generateUniqueId(const std::string &table) const {
  * uppercase letters, and digits. The generated string can be used, for example,
  * as a unique identifier or token.
  *
- * Thread-safety: Since this function utilizes a local random number generator,
- * it is thread-safe when accessed concurrently by multiple threads.
+ * The characters are drawn from the handler's generator, which is seeded once when the
+ * handler is created rather than for every id.
+ *
+ * Thread-safety: This method is not thread-safe, like the rest of the handler.
  *
  * Exception safety: If memory allocation for the result string fails, an exception
  * may be thrown. This should be handled by the caller.
@@ -650,15 +1253,14 @@ std::string SQLiteHandler::generateUniqueId(const std::string &table) const {
  *                   It must be greater than 0 for meaningful output.
  * @return A random alphanumeric string of the specified length.
  */
-std::string SQLiteHandler::generateId(const size_t length) {
-    const std::string chars = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-    std::random_device rd;
-    std::mt19937 generator(rd());
-    std::uniform_int_distribution<> distribution(0, chars.size() - 1);
+std::string SQLiteHandler::generateId(const size_t length) const {
+    static constexpr std::string_view chars = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    std::uniform_int_distribution<size_t> distribution(0, chars.size() - 1);
 
     std::string randomString;
+    randomString.reserve(length);
     for (size_t i = 0; i < length; ++i) {
-        randomString += chars[distribution(generator)];
+        randomString += chars[distribution(this->idGenerator)];
     }
     return randomString;
 }
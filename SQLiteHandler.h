@@ -1,10 +1,18 @@
 ﻿#ifndef SQLITEHANDLER_H
 #define SQLITEHANDLER_H
+#include <array>
+#include <random>
 #include <string>
+#include <utility>
 
+#include "CodeDictionary.h"
 #include "Measurement.h"
+#include "MeasurementBatch.h"
 #include "Station.h"
+#include "AdditionalSections.h"
+#include "FileManifest.h"
 #include "SQLiteCpp/Database.h"
+#include "SQLiteCpp/Statement.h"
 
 
 /**
@@ -20,6 +28,7 @@ public:
     Station getStation(const std::string &stationId) const;
     Measurement& insertMeasurement(Measurement& measurement) const;
     void insertMeasurements(std::vector<Measurement>& measurements) const;
+    void insertMeasurements(const MeasurementBatch& measurements) const;
     Station& insertStation(Station& station) const;
     void insertStations(std::vector<Station>& stations) const;
     Measurement& updateMeasurements(Measurement& measurement);
@@ -31,16 +40,40 @@ public:
     std::vector<Station> getAllStations() const;
     int countMeasurements() const;
     int countStations() const;
+    int backfillSections(const std::vector<const SectionDecoder*>& sections);
+    std::map<std::string, ManifestEntry> getManifest() const;
+    int64_t insertManifestEntry(const ManifestEntry& entry) const;
+    void updateManifestEntry(const ManifestEntry& entry) const;
+    int deleteMeasurementsOfFile(int64_t file) const;
+    MeasurementDictionaries& getDictionaries();
+    void beginTransaction();
+    void commitTransaction();
+    void rollbackTransaction();
     ~SQLiteHandler();
     std::vector<std::map<std::string, std::string>> executeQuery(const std::string &query);
 
     std::string generateUniqueId(const std::string &table) const;
 
 private:
+    // Writes rows with the prepared statements and row inserts below
+    friend class BulkWriter;
+
     std::string database;
     SQLite::Database db;
+    // Codes are assigned while rows are bound, also by the const insert methods
+    mutable MeasurementDictionaries dictionaries;
+    // Seeded once; every inserted measurement draws its id from it
+    mutable std::mt19937_64 idGenerator;
 
-    static std::string generateId(size_t length);
+    std::array<std::pair<const char*, CodeDictionary*>, 3> dictionaryTables() const;
+    void loadDictionaries();
+    void storeDictionaries() const;
+    void insertRow(SQLite::Statement& query, const MeasurementBatch& batch, size_t row, size_t& next) const;
+    void insertRow(SQLite::Statement& query, const Station& station) const;
+    static std::string insertMeasurementSql();
+    static std::string insertStationSql();
+    static std::string idCheckSql(const std::string& table);
+    std::string generateId(size_t length) const;
 };
 
 
@@ -1,49 +1,36 @@
 ﻿#include "Station.h"
-#include <iostream>
-#include <sstream>
 #include <vector>
 
+#include "ColumnPlan.h"
+#include "FieldParser.h"
+
 /**
- * Parses a CSV line and constructs a Station object using the extracted data.
- * The method assumes the CSV line is structured with specific fields and uses
- * their positions to populate the attributes of a Station object.
+ * Constructs a Station object from the fields of a tokenized CSV line.
+ * The fields are taken from the positions the file's `ColumnPlan` resolved
+ * from its header.
  *
- * @param line A string representing a single row of CSV data. Each field is separated
- *             by a comma, and fields potentially containing commas are enclosed in quotes.
- * @return A Station object constructed using the data extracted from the CSV line.
+ * @param tokens The fields of a single CSV line as produced by `CsvTokenizer::tokenize`.
+ *               The views point into the read buffer and are only copied where stored.
+ * @param plan The column plan of the file the line belongs to.
+ * @param errors Per-field conversion failure counters; coordinates that fail to convert
+ *               are counted here and keep their default value.
+ * @return A Station object constructed using the data extracted from the fields.
  *         In case of parsing issues, an empty Station object may be returned.
  */
-Station Station::fromCsv(std::string line) {
+Station Station::fromCsv(const std::vector<std::string_view>& tokens, const ColumnPlan& plan, ParseErrors& errors) {
     Station station = {};
 
-    std::vector<std::string> tokens;
-    std::string token;
-    bool inQuotes = false;
-
-    for (char c : line) {
-        if (c == '"') {
-            // Toggle the inQuotes flag
-            inQuotes = !inQuotes;
-        } else if (c == ',' && !inQuotes) {
-            // Split at comma if not inside quotes
-            tokens.push_back(token);
-            token.clear();
-        } else {
-            // Append character to the current token
-            token += c;
-        }
+    if (tokens.size() < plan.width) {
+        errors.record(CsvField::Line, ParseResult::Invalid);
+        return station;
     }
 
-    try {
-        station.id = tokens[0];
-        station.name = tokens[6];
-        station.latitude = std::stod(tokens[3]);
-        station.longitude = std::stod(tokens[4]);
-        station.elevation = std::stod(tokens[5]);
-        station.callSign = tokens[8];
-    }catch (const std::exception& e) {
-        std::cerr << "Error: " << e.what() << std::endl;
-    }
+    station.id = plan.field(tokens, CsvColumn::Station);
+    station.name = plan.field(tokens, CsvColumn::Name);
+    FieldParser::parseDouble(plan.field(tokens, CsvColumn::Latitude), station.latitude, CsvField::Latitude, errors);
+    FieldParser::parseDouble(plan.field(tokens, CsvColumn::Longitude), station.longitude, CsvField::Longitude, errors);
+    FieldParser::parseDouble(plan.field(tokens, CsvColumn::Elevation), station.elevation, CsvField::Elevation, errors);
+    station.callSign = plan.field(tokens, CsvColumn::CallSign);
 
     return station;
 
@@ -1,6 +1,12 @@
 ﻿#ifndef STATION_H
 #define STATION_H
 #include <string>
+#include <string_view>
+#include <vector>
+
+#include "FieldParser.h"
+
+class ColumnPlan;
 
 
 /**
@@ -9,7 +15,8 @@
  *
  * This class stores information about a station including its unique identification,
  * geographical coordinates (latitude, longitude), elevation, and other attributes like name
- * and call sign. It also provides functionality to create a Station object from a CSV formatted string.
+ * and call sign. It also provides functionality to create a Station object from the fields of
+ * a tokenized CSV line.
  */
 class Station {
 public:
@@ -20,7 +27,7 @@ public:
     double elevation;
     std::string callSign;
 
-    static Station fromCsv(std::string line);
+    static Station fromCsv(const std::vector<std::string_view>& tokens, const ColumnPlan& plan, ParseErrors& errors);
 };
 
 
@@ -0,0 +1,73 @@
+﻿#include "StationRegistry.h"
+#include <cstdint>
+
+/**
+ * @brief Adds a station id to the registry if it is not present yet.
+ *
+ * Only the shard the id hashes to is locked. When several threads insert the same id at the
+ * same time, exactly one of them gets `true` back, so exactly one of them saves the station.
+ *
+ * @param id The station id to add.
+ * @return True if the id was newly added, false if it had been seen before.
+ */
+bool StationRegistry::insert(std::string_view id) {
+    const size_t hash = Hash{}(id);
+    Shard& shard = this->shards[shardIndex(hash)];
+
+    std::lock_guard lock(shard.mutex);
+    if (shard.ids.find(id) != shard.ids.end()) {
+        return false;
+    }
+    shard.ids.emplace(id);
+    return true;
+}
+
+/**
+ * @brief Checks whether a station id has been registered.
+ *
+ * @param id The station id to look up.
+ * @return True if the id is in the registry.
+ */
+bool StationRegistry::contains(std::string_view id) const {
+    const size_t hash = Hash{}(id);
+    const Shard& shard = this->shards[shardIndex(hash)];
+
+    std::lock_guard lock(shard.mutex);
+    return shard.ids.find(id) != shard.ids.end();
+}
+
+/**
+ * @brief Returns the number of registered station ids.
+ *
+ * The shards are locked one after another, so the result is only exact while no other thread
+ * is inserting.
+ */
+size_t StationRegistry::size() const {
+    size_t total = 0;
+    for (const Shard& shard : this->shards) {
+        std::lock_guard lock(shard.mutex);
+        total += shard.ids.size();
+    }
+    return total;
+}
+
+/**
+ * @brief Removes every station id from the registry.
+ */
+void StationRegistry::clear() {
+    for (Shard& shard : this->shards) {
+        std::lock_guard lock(shard.mutex);
+        shard.ids.clear();
+    }
+}
+
+/**
+ * @brief Maps a hash to a shard using its high bits.
+ *
+ * The hash sets inside the shards bucket by the low bits, so taking the shard from the
+ * mixed high bits keeps ids evenly spread within each shard as well.
+ */
+size_t StationRegistry::shardIndex(size_t hash) {
+    const uint64_t mixed = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(mixed >> 58) % shardCount;
+}
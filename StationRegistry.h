@@ -0,0 +1,47 @@
+﻿#ifndef STATIONREGISTRY_H
+#define STATIONREGISTRY_H
+#include <array>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+/**
+ * @class StationRegistry
+ * @brief Thread-safe set of the station ids seen during a load.
+ *
+ * The registry answers "is this station new?" in constant time and may be used from any number
+ * of loader threads at once. Ids are spread over a fixed number of shards, each a hash set with
+ * its own mutex, so concurrent batches rarely contend for the same lock. Lookups take a
+ * `std::string_view` and do not allocate unless the id is actually inserted.
+ */
+class StationRegistry {
+public:
+    static constexpr size_t shardCount = 64;
+
+    bool insert(std::string_view id);
+    bool contains(std::string_view id) const;
+    size_t size() const;
+    void clear();
+private:
+    struct Hash {
+        using is_transparent = void;
+        size_t operator()(std::string_view id) const {
+            return std::hash<std::string_view>{}(id);
+        }
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_set<std::string, Hash, std::equal_to<>> ids;
+    };
+
+    std::array<Shard, shardCount> shards;
+
+    static size_t shardIndex(size_t hash);
+};
+
+
+
+#endif //STATIONREGISTRY_H
@@ -0,0 +1,293 @@
+﻿#include "TarArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+
+/**
+ * @brief Reads a NUL- or space-terminated octal header field, or a GNU base-256 number.
+ */
+uint64_t parseNumber(const char* field, size_t length) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(field);
+    uint64_t value = 0;
+
+    if (bytes[0] & 0x80) {
+        // Base-256: used by GNU tar for sizes of 8 GiB and more
+        value = bytes[0] & 0x7F;
+        for (size_t i = 1; i < length; ++i) {
+            value = (value << 8) | bytes[i];
+        }
+        return value;
+    }
+
+    size_t i = 0;
+    while (i < length && field[i] == ' ') {
+        ++i;
+    }
+    for (; i < length && field[i] >= '0' && field[i] <= '7'; ++i) {
+        value = (value << 3) | (field[i] - '0');
+    }
+    return value;
+}
+
+std::string parseText(const char* field, size_t length) {
+    return std::string(field, strnlen(field, length));
+}
+
+/**
+ * @brief Checks the header checksum, which counts the checksum field itself as spaces.
+ */
+bool validChecksum(const char* header) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < TarArchive::blockSize; ++i) {
+        sum += (i >= 148 && i < 156) ? ' ' : static_cast<unsigned char>(header[i]);
+    }
+    return sum == parseNumber(header + 148, 8);
+}
+
+/**
+ * @brief Extracts the "path" record from a pax extended header, if present.
+ *
+ * Records have the form "<length> <key>=<value>\n".
+ */
+std::string paxPath(std::string_view records) {
+    std::string path;
+    while (!records.empty()) {
+        const size_t space = records.find(' ');
+        if (space == std::string_view::npos) {
+            break;
+        }
+        size_t length = 0;
+        for (const char c : records.substr(0, space)) {
+            length = length * 10 + (c - '0');
+        }
+        if (length <= space || length > records.size()) {
+            break;
+        }
+
+        const std::string_view record = records.substr(space + 1, length - space - 2);
+        if (record.starts_with("path=")) {
+            path = record.substr(5);
+        }
+        records.remove_prefix(length);
+    }
+    return path;
+}
+
+}
+
+/**
+ * @brief Opens an archive, decompressing it on the fly if its extension says so.
+ *
+ * Whether opening succeeded can be checked with `isOpen`.
+ *
+ * @param path The path of the archive.
+ */
+TarArchive::TarArchive(const std::filesystem::path& path) {
+#ifdef _WIN32
+    this->stream = _wfopen(path.c_str(), L"rb");
+#else
+    this->stream = std::fopen(path.c_str(), "rb");
+#endif
+    if (this->stream == nullptr) {
+        return;
+    }
+
+    const Decompressor::Format format = Decompressor::detect(path);
+    if (format == Decompressor::Format::None) {
+        // Headers are read 512 bytes at a time, so let stdio read ahead in large blocks
+        std::setvbuf(this->stream, nullptr, _IOFBF, Decompressor::inputSize);
+        return;
+    }
+
+    std::setvbuf(this->stream, nullptr, _IONBF, 0);
+    this->decompressor = Decompressor::open(this->stream, format);
+    if (this->decompressor == nullptr) {
+        std::fclose(this->stream);
+        this->stream = nullptr;
+    }
+}
+
+/**
+ * @brief Closes the archive.
+ */
+TarArchive::~TarArchive() {
+    this->decompressor.reset();
+    if (this->stream != nullptr) {
+        std::fclose(this->stream);
+    }
+}
+
+/**
+ * @brief Checks whether a path names a regular file with a tar archive extension.
+ *
+ * @param path The path given to `load --path`.
+ * @return True for ".tar", ".tar.gz", ".tgz" and ".tar.zst" files.
+ */
+bool TarArchive::isArchive(const std::filesystem::path& path) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        return false;
+    }
+    if (path.extension() == ".tar" || path.extension() == ".tgz") {
+        return true;
+    }
+    return Decompressor::detect(path) != Decompressor::Format::None && path.stem().extension() == ".tar";
+}
+
+/**
+ * @brief Reports whether the archive could be opened and its compression is supported.
+ */
+bool TarArchive::isOpen() const {
+    return this->stream != nullptr;
+}
+
+/**
+ * @brief Moves to the next regular file in the archive.
+ *
+ * The unread contents of the current member are skipped. Directories, links and other entries
+ * are skipped as well; pax and GNU long-name entries are applied to the member they describe.
+ *
+ * @param member Receives the name, size and modification time of the next regular file.
+ * @return True if a member was found, false at the end of the archive or on a damaged header.
+ */
+bool TarArchive::next(TarMember& member) {
+    std::string longName;
+
+    while (this->stream != nullptr) {
+        if (!skip(this->remaining + this->padding)) {
+            return false;
+        }
+        this->remaining = 0;
+        this->padding = 0;
+
+        char header[blockSize];
+        if (!readBytes(header, blockSize)) {
+            return false;
+        }
+        if (std::all_of(header, header + blockSize, [](char c) { return c == '\0'; })) {
+            return false;
+        }
+        if (!validChecksum(header)) {
+            std::cerr << "Error: Damaged tar header, stopping." << std::endl;
+            return false;
+        }
+
+        const uint64_t size = parseNumber(header + 124, 12);
+        const char type = header[156];
+        this->remaining = size;
+        this->padding = (blockSize - size % blockSize) % blockSize;
+
+        if (type == 'L' || type == 'x') {
+            std::string text;
+            if (!readText(size, text)) {
+                return false;
+            }
+            longName = type == 'L' ? std::string(text.c_str()) : paxPath(text);
+            continue;
+        }
+        if (type != '0' && type != '\0') {
+            longName.clear();
+            continue;
+        }
+
+        if (!longName.empty()) {
+            member.name = longName;
+        } else {
+            member.name = parseText(header, 100);
+            const std::string prefix = parseText(header + 345, 155);
+            if (std::memcmp(header + 257, "ustar", 5) == 0 && !prefix.empty()) {
+                member.name = prefix + "/" + member.name;
+            }
+        }
+        member.size = size;
+        member.mtime = static_cast<int64_t>(parseNumber(header + 136, 12));
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Reads the whole contents of the current member.
+ *
+ * @param contents Receives the member's bytes.
+ * @return True on success, false if the archive ended early.
+ */
+bool TarArchive::read(std::vector<char>& contents) {
+    contents.resize(this->remaining);
+    if (!readBytes(contents.data(), contents.size())) {
+        contents.clear();
+        return false;
+    }
+    this->remaining = 0;
+    return true;
+}
+
+/**
+ * @brief Reads the next bytes of the current member.
+ *
+ * Suited as a `FileReader::Source`, so a large member is parsed without being held in memory.
+ *
+ * @param output The buffer to fill.
+ * @param size The capacity of the buffer.
+ * @return The number of bytes written; less than `size` only at the end of the member.
+ * @throws std::runtime_error If the archive ends before the member does.
+ */
+size_t TarArchive::readSome(char* output, size_t size) {
+    const size_t step = static_cast<size_t>(std::min<uint64_t>(size, this->remaining));
+    if (step == 0) {
+        return 0;
+    }
+    if (!readBytes(output, step)) {
+        throw std::runtime_error("Truncated tar archive.");
+    }
+    this->remaining -= step;
+    return step;
+}
+
+/**
+ * @brief Reads exactly `size` bytes from the archive, decompressing if needed.
+ */
+bool TarArchive::readBytes(char* output, size_t size) {
+    const size_t read = this->decompressor != nullptr
+        ? this->decompressor->read(output, size)
+        : std::fread(output, 1, size, this->stream);
+    if (read != size) {
+        if (read != 0) {
+            std::cerr << "Error: Truncated tar archive." << std::endl;
+        }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Skips `size` bytes of the archive by reading them into a scratch buffer.
+ */
+bool TarArchive::skip(uint64_t size) {
+    char scratch[64 * 1024];
+    while (size > 0) {
+        const size_t step = static_cast<size_t>(std::min<uint64_t>(size, sizeof(scratch)));
+        if (!readBytes(scratch, step)) {
+            return false;
+        }
+        size -= step;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the data of a metadata entry, such as a long name; `next` skips its padding.
+ */
+bool TarArchive::readText(uint64_t size, std::string& text) {
+    text.resize(size);
+    if (!readBytes(text.data(), text.size())) {
+        return false;
+    }
+    this->remaining = 0;
+    return true;
+}
@@ -0,0 +1,61 @@
+﻿#ifndef TARARCHIVE_H
+#define TARARCHIVE_H
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Decompressor.h"
+
+/**
+ * @struct TarMember
+ * @brief A regular file stored in a tar archive, as described by its header.
+ */
+struct TarMember {
+    std::string name;
+    uint64_t size = 0;
+    int64_t mtime = 0;
+};
+
+/**
+ * @class TarArchive
+ * @brief Reads the members of a tar archive one after another in a single sequential pass.
+ *
+ * The archive may be plain or compressed with gzip or zstd (".tar", ".tar.gz", ".tgz",
+ * ".tar.zst"); compressed archives are decompressed on the fly, nothing is extracted to disk.
+ * `next` moves to the next regular file; `read` returns its whole contents, and `readSome`
+ * streams them in pieces of any size. Members whose contents are not read are skipped. POSIX
+ * (pax) and GNU long names are supported. A damaged compressed archive throws the error of
+ * its `Decompressor` from any of the reading methods.
+ */
+class TarArchive {
+public:
+    static constexpr size_t blockSize = 512;
+
+    explicit TarArchive(const std::filesystem::path& path);
+    TarArchive(const TarArchive&) = delete;
+    TarArchive& operator=(const TarArchive&) = delete;
+    ~TarArchive();
+
+    static bool isArchive(const std::filesystem::path& path);
+
+    bool isOpen() const;
+    bool next(TarMember& member);
+    bool read(std::vector<char>& contents);
+    size_t readSome(char* output, size_t size);
+private:
+    std::FILE* stream = nullptr;
+    std::unique_ptr<Decompressor> decompressor;
+    uint64_t remaining = 0;
+    uint64_t padding = 0;
+
+    bool readBytes(char* output, size_t size);
+    bool skip(uint64_t size);
+    bool readText(uint64_t size, std::string& text);
+};
+
+
+
+#endif //TARARCHIVE_H
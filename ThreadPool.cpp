@@ -0,0 +1,152 @@
+﻿#include "ThreadPool.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+
+}
+
+/**
+ * @brief Starts the worker threads.
+ *
+ * @param threads The number of worker threads; 0 uses one per hardware thread.
+ */
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < threads; ++i) {
+        this->workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        this->threads.emplace_back([this, i] { run(i); });
+    }
+}
+
+/**
+ * @brief Waits for all submitted tasks to finish and joins the worker threads.
+ */
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard lock(this->stateMutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (std::thread& thread : this->threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Returns the number of worker threads.
+ */
+size_t ThreadPool::size() const {
+    return this->threads.size();
+}
+
+/**
+ * @brief Schedules a task on the pool.
+ *
+ * A task submitted from one of the pool's own workers is pushed onto that worker's deque,
+ * which keeps related work on the same core. Tasks from other threads are distributed
+ * round-robin over all workers.
+ *
+ * @param task The task to run.
+ */
+void ThreadPool::submit(std::function<void()> task) {
+    const size_t index = currentPool == this
+        ? currentWorker
+        : this->nextWorker.fetch_add(1, std::memory_order_relaxed) % this->workers.size();
+
+    this->pending++;
+    {
+        // Counting under the lock keeps a worker from going to sleep right past this task
+        std::lock_guard lock(this->stateMutex);
+        this->queued++;
+    }
+    {
+        std::lock_guard lock(this->workers[index]->mutex);
+        this->workers[index]->tasks.push_back(std::move(task));
+    }
+    this->wake.notify_one();
+}
+
+/**
+ * @brief Blocks until every task submitted so far, including tasks they submit, has finished.
+ *
+ * Must not be called from a task running on this pool.
+ */
+void ThreadPool::wait() {
+    std::unique_lock lock(this->stateMutex);
+    this->idle.wait(lock, [this] { return this->pending == 0; });
+}
+
+/**
+ * @brief Takes the newest task from a worker's own deque.
+ */
+bool ThreadPool::popLocal(size_t index, std::function<void()>& task) {
+    Worker& worker = *this->workers[index];
+    std::lock_guard lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+/**
+ * @brief Takes the oldest task from the first other worker that has one.
+ */
+bool ThreadPool::steal(size_t index, std::function<void()>& task) {
+    for (size_t offset = 1; offset < this->workers.size(); ++offset) {
+        Worker& victim = *this->workers[(index + offset) % this->workers.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Main loop of a worker: run own tasks, steal when out of work, sleep when all are idle.
+ *
+ * An exception escaping a task is logged and does not stop the worker; tasks that need to
+ * report failures should be submitted through `async`.
+ */
+void ThreadPool::run(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    while (true) {
+        std::function<void()> task;
+        if (popLocal(index, task) || steal(index, task)) {
+            this->queued--;
+            try {
+                task();
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+            }
+
+            if (--this->pending == 0) {
+                std::lock_guard lock(this->stateMutex);
+                this->idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock lock(this->stateMutex);
+        this->wake.wait(lock, [this] { return this->stopping || this->queued > 0; });
+        if (this->stopping && this->queued == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+﻿#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed-size work-stealing thread pool for all parallel work of the CLI.
+ *
+ * The pool starts a fixed number of threads, by default one per hardware thread, so the
+ * amount of parallel work never oversubscribes the machine no matter how many tasks are
+ * submitted. Every worker owns a task deque: tasks submitted from a worker go to its own
+ * deque and are run newest-first, tasks submitted from outside are spread round-robin, and an
+ * idle worker steals the oldest task from another worker's deque.
+ *
+ * Destroying the pool waits for all submitted tasks to finish.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    size_t size() const;
+    void submit(std::function<void()> task);
+    void wait();
+
+    /**
+     * @brief Submits a callable and returns a future for its result.
+     *
+     * @param function The callable to run on the pool.
+     * @return A future that receives the result or the exception thrown by the callable.
+     */
+    template <typename Function>
+    auto async(Function&& function) -> std::future<std::invoke_result_t<Function>> {
+        using Result = std::invoke_result_t<Function>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        std::future<Result> future = task->get_future();
+        submit([task] { (*task)(); });
+        return future;
+    }
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> nextWorker = 0;
+    std::atomic<size_t> queued = 0;
+    std::atomic<size_t> pending = 0;
+    std::mutex stateMutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    bool stopping = false;
+
+    bool popLocal(size_t index, std::function<void()>& task);
+    bool steal(size_t index, std::function<void()>& task);
+    void run(size_t index);
+};
+
+
+
+#endif //THREADPOOL_H
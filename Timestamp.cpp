@@ -0,0 +1,154 @@
+﻿#include "Timestamp.h"
+
+namespace {
+
+/**
+ * @brief Returns the number of days from 1970-01-01 to a date of the proleptic Gregorian calendar.
+ *
+ * Counts from March 1st, so the leap day falls at the end of the shifted year and every term is
+ * plain integer arithmetic (H. Hinnant, "chrono-Compatible Low-Level Date Algorithms").
+ */
+constexpr int64_t daysFromCivil(int64_t year, int64_t month, int64_t day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yearOfEra = year - era * 400;
+    const int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * @brief The inverse of `daysFromCivil`.
+ */
+constexpr void civilFromDays(int64_t days, int64_t& year, int64_t& month, int64_t& day) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int64_t dayOfEra = days - era * 146097;
+    const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    year = yearOfEra + era * 400 + (month <= 2);
+}
+
+static_assert(daysFromCivil(1970, 1, 1) == 0);
+static_assert(daysFromCivil(2000, 3, 1) == 11017);
+
+/**
+ * @brief The days of each month in a common year, indexed by the month; the padding keeps any
+ *        four-bit index in range.
+ */
+constexpr unsigned char monthDays[16] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31, 0, 0, 0};
+
+/**
+ * @brief Writes a number as a fixed count of decimal digits.
+ */
+void writeDigits(char* out, int64_t value, int count) {
+    for (int i = count - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+}
+
+/**
+ * @brief Converts an ISO time "YYYY-MM-DDTHH:MM:SS" into seconds since the epoch.
+ *
+ * The layout is fixed, so each digit is read from its position and the checks of all digits,
+ * separators and ranges are combined into a single flag that is tested once at the end. The
+ * day is checked against the length of its month, looked up in a table plus a leap-year term
+ * for February, so e.g. 2023-02-29 is rejected instead of rolling over into March. On failure
+ * `value` is left unchanged.
+ *
+ * @param field The field to convert.
+ * @param value Receives the time in seconds since 1970-01-01T00:00:00 UTC on success.
+ * @return `ParseResult::Ok` on success, otherwise the reason the conversion failed.
+ */
+ParseResult Timestamp::parseIso(std::string_view field, int64_t& value) {
+    if (field.empty()) {
+        return ParseResult::Empty;
+    }
+    if (field.size() != 19) {
+        return ParseResult::Invalid;
+    }
+
+    const auto digit = [&](size_t index) {
+        return static_cast<unsigned>(static_cast<unsigned char>(field[index]) - '0');
+    };
+    const unsigned d[] = {
+        digit(0), digit(1), digit(2), digit(3), digit(5), digit(6), digit(8), digit(9),
+        digit(11), digit(12), digit(14), digit(15), digit(17), digit(18),
+    };
+
+    unsigned invalid = 0;
+    for (const unsigned each : d) {
+        invalid |= each > 9;
+    }
+    invalid |= (field[4] ^ '-') | (field[7] ^ '-') | (field[10] ^ 'T') | (field[13] ^ ':') | (field[16] ^ ':');
+
+    const unsigned year = d[0] * 1000 + d[1] * 100 + d[2] * 10 + d[3];
+    const unsigned month = d[4] * 10 + d[5];
+    const unsigned day = d[6] * 10 + d[7];
+    const unsigned hour = d[8] * 10 + d[9];
+    const unsigned minute = d[10] * 10 + d[11];
+    const unsigned second = d[12] * 10 + d[13];
+    const unsigned leap = (year % 4 == 0) & ((year % 100 != 0) | (year % 400 == 0));
+    const unsigned monthLength = monthDays[month & 15] + ((month == 2) & leap);
+    invalid |= (month - 1 > 11) | (day - 1 >= monthLength) | (hour > 23) | (minute > 59) | (second > 59);
+
+    if (invalid != 0) {
+        return ParseResult::Invalid;
+    }
+
+    value = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return ParseResult::Ok;
+}
+
+/**
+ * @brief Converts an ISO time into seconds since the epoch and counts a failure as a date error.
+ *
+ * @param field The field to convert.
+ * @param value Receives the converted time on success.
+ * @param errors The counters a failure is recorded in.
+ * @return The outcome of the conversion.
+ */
+ParseResult Timestamp::parseIso(std::string_view field, int64_t& value, ParseErrors& errors) {
+    const ParseResult result = parseIso(field, value);
+    errors.record(CsvField::Date, result);
+    return result;
+}
+
+/**
+ * @brief Formats seconds since the epoch in NOAA's layout "YYYY-MM-DDTHH:MM:SS".
+ *
+ * @param value The time to format.
+ * @return The ISO text, or an empty string for `timestampMissing`.
+ */
+std::string Timestamp::formatIso(int64_t value) {
+    if (value == timestampMissing) {
+        return {};
+    }
+
+    int64_t days = value / 86400;
+    int64_t seconds = value % 86400;
+    if (seconds < 0) {
+        seconds += 86400;
+        days--;
+    }
+
+    int64_t year = 0;
+    int64_t month = 0;
+    int64_t day = 0;
+    civilFromDays(days, year, month, day);
+
+    std::string text = "0000-00-00T00:00:00";
+    writeDigits(text.data(), year, 4);
+    writeDigits(text.data() + 5, month, 2);
+    writeDigits(text.data() + 8, day, 2);
+    writeDigits(text.data() + 11, seconds / 3600, 2);
+    writeDigits(text.data() + 14, seconds / 60 % 60, 2);
+    writeDigits(text.data() + 17, seconds % 60, 2);
+    return text;
+}
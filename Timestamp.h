@@ -0,0 +1,37 @@
+﻿#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "FieldParser.h"
+
+/**
+ * @brief Value of a timestamp that is missing or could not be parsed.
+ *
+ * The database binds this as NULL, so such rows never match a time range.
+ */
+constexpr int64_t timestampMissing = std::numeric_limits<int64_t>::min();
+
+/**
+ * @class Timestamp
+ * @brief Converts NOAA observation times between their ISO text and seconds since the epoch.
+ *
+ * Measurements store the DATE field as an INTEGER of seconds since 1970-01-01T00:00:00 UTC,
+ * so time ranges compare integers and take eight bytes instead of nineteen. The text is only
+ * produced again on output.
+ *
+ * NOAA writes every time in the same fixed layout "YYYY-MM-DDTHH:MM:SS", so `parseIso` reads
+ * the digits at fixed positions and validates them all at once, without a branch per character.
+ */
+class Timestamp {
+public:
+    static ParseResult parseIso(std::string_view field, int64_t& value);
+    static ParseResult parseIso(std::string_view field, int64_t& value, ParseErrors& errors);
+    static std::string formatIso(int64_t value);
+};
+
+
+
+#endif //TIMESTAMP_H
@@ -2,8 +2,106 @@
 #include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <filesystem>
 #include <future>
+#include <semaphore>
+#include <stdexcept>
+#include <thread>
 #include "barkeep.h"
+#include "BoundedQueue.h"
+#include "BulkWriter.h"
+#include "CsvTokenizer.h"
+#include "FileReader.h"
+#include "FileManifest.h"
+#include "Decompressor.h"
+#include "TarArchive.h"
+#include "FileDiscovery.h"
+#include "FileSplitter.h"
+
+namespace {
+
+/**
+ * @brief Checks for a CSV file, plain or compressed with gzip or zstd.
+ */
+bool isCsvFile(const std::filesystem::path& path) {
+    if (Decompressor::detect(path) != Decompressor::Format::None) {
+        return path.stem().extension() == ".csv";
+    }
+    return path.extension() == ".csv";
+}
+
+volatile std::sig_atomic_t interruptRequested = 0;
+
+/**
+ * @brief Returns the scratch database `replay` writes to, so weather.db is never touched.
+ */
+std::filesystem::path replayDatabase() {
+    return std::filesystem::temp_directory_path() / "weather_cli-replay.db";
+}
+
+/**
+ * @brief Returns the database a handler with the given options opens.
+ *
+ * A scratch database left behind by an earlier replay is removed first, so every replay
+ * starts from an empty file.
+ */
+std::string databaseFor(const LoadOptions& options) {
+    if (!options.replay) {
+        return "weather.db";
+    }
+    std::error_code ignored;
+    std::filesystem::remove(replayDatabase(), ignored);
+    return replayDatabase().string();
+}
+
+void onInterrupt(int) {
+    interruptRequested = 1;
+    // A second Ctrl-C terminates immediately
+    std::signal(SIGINT, SIG_DFL);
+}
+
+/**
+ * @brief Routes SIGINT to the loader for the lifetime of a load, then restores the previous handler.
+ *
+ * An interrupted load stops taking new files but finishes and commits the files already in
+ * flight, so `load --resume` can continue from there.
+ */
+class InterruptGuard {
+public:
+    InterruptGuard() : previous(std::signal(SIGINT, onInterrupt)) {
+        interruptRequested = 0;
+    }
+    ~InterruptGuard() {
+        std::signal(SIGINT, this->previous == SIG_ERR ? SIG_DFL : this->previous);
+    }
+private:
+    void (*previous)(int);
+};
+
+/**
+ * @brief Releases a slot of the files in flight when a parse task ends, even if it throws.
+ *
+ * The thread pool reports and drops a task's exception, so a slot released only on return
+ * would be lost, and the thread handing out files would block on it forever.
+ */
+class SlotGuard {
+public:
+    explicit SlotGuard(std::counting_semaphore<>& slots) : slots(slots) {
+    }
+    ~SlotGuard() {
+        this->slots.release();
+    }
+    SlotGuard(const SlotGuard&) = delete;
+    SlotGuard& operator=(const SlotGuard&) = delete;
+private:
+    std::counting_semaphore<>& slots;
+};
+
+}
 
 /**
  * @brief Constructs a WeatherHandler object and initializes the necessary resources.
@@ -11,17 +109,34 @@
  * This constructor initializes the WeatherHandler class by setting the provided
  * `path` and `options` values. It also prepares the SQLiteHandler by cleaning
  * the existing database and reinitializing it. This ensures the database is in
- * a consistent state for further operations.
+ * a consistent state for further operations. With `options.append` the database
+ * is kept instead, and the stations already stored are registered so they are
+ * not inserted twice. With `options.parseOnly` the database is neither cleaned nor
+ * initialized. With `options.replay` a fresh scratch database is opened and initialized in
+ * place of weather.db. Rejected rows are written to `options.rejects`. The worker pool is
+ * started here with `options.threads` threads and shared by all parallel work of the handler.
  *
  * @param path A string representing the path to the data source.
  * @param options A LoadOptions struct that defines parameters such as limit,
  * batch size, and flags for async or batch processing.
  */
-WeatherHandler::WeatherHandler(std::string path, LoadOptions options) : db("weather.db") {
+WeatherHandler::WeatherHandler(std::string path, LoadOptions options) : db(databaseFor(options)), pool(options.threads), rejects(options.rejects) {
     this->path = std::move(path);
-    this->options = &options;
-    db.cleanDatabase();
+    this->options = options;
+    this->sectionDecoders = AdditionalSections::select(this->options.sections);
+    if (this->options.parseOnly) {
+        return;
+    }
+    if (!this->options.append && !this->options.replay) {
+        db.cleanDatabase();
+    }
     db.init();
+
+    if (this->options.append) {
+        for (const Station& station : db.getAllStations()) {
+            this->stations.insert(station.id);
+        }
+    }
 }
 
 /**
@@ -31,76 +146,75 @@ WeatherHandler::WeatherHandler(std::string path, LoadOptions options) : db("weat
  * - Retrieves a list of files from the specified path using the `loadFiles` method.
  * - Passes the retrieved files along with the given mutex to the `loadBatch` method for processing.
  *
+ * If the path is a tar archive, its members are loaded by `loadArchive` instead. The stage
+ * timings of the load are written to `options.metrics`.
+ *
  * @param mutex A reference to a `std::mutex` object used to synchronize access during
  * batch loading to ensure thread-safety.
  */
 void WeatherHandler::load(std::mutex& mutex) {
-    std::vector<std::filesystem::directory_entry> files = loadFiles();
-    loadBatch(mutex, files);
+    InterruptGuard interruptGuard;
+    this->metrics.start();
+    if (TarArchive::isArchive(this->path)) {
+        loadArchive(mutex);
+    } else {
+        std::vector<ManifestEntry> files = loadFiles();
+        loadBatch(mutex, files);
+    }
+    finishMetrics();
 }
 
 /**
  * @brief Processes a batch of files and extracts measurements and station data.
  *
- * This method iterates over the provided files, isolates CSV files, and reads
- * each file line by line to parse measurement and station data. If a station
- * is newly encountered, it is added to the station list. Progress is displayed
- * using progress bars, and measurements and station data are saved to the
- * appropriate storage using thread-safe mechanisms.
+ * This method iterates over the provided files and reads each file through a
+ * memory-mapped `FileReader`, so lines are views into the
+ * mapping rather than copies. Each file is parsed by `parseFile`, which hands
+ * over the rows in chunks of `options.chunkRows`; every chunk is saved before
+ * the next one is parsed, so memory stays bounded no matter how large a file
+ * is. Progress is displayed using progress bars, and measurements and station
+ * data are saved to the appropriate storage using thread-safe mechanisms.
+ * Conversion failures are counted per chunk and merged into the handler's
+ * totals. Each file is written by `saveFile` in one transaction. A file that
+ * cannot be read to its end, such as a truncated gzip file, is reported and
+ * rolled back, so it stays marked incomplete. After Ctrl-C the current file is
+ * finished and no further file is started.
  *
  * @param mutex A reference to a std::mutex used for thread synchronization
  * when saving data or updating shared resources.
- * @param files A vector of std::filesystem::directory_entry objects
- * representing files to be processed.
+ * @param files The manifest entries of the files to be processed, as returned
+ * by `loadFiles`.
  */
-void WeatherHandler::loadBatch(std::mutex &mutex, std::vector<std::filesystem::directory_entry> files) {
-    for (const auto& entry: files) {
-        if (entry.is_regular_file() && entry.path().extension() != ".csv") {
-            continue;
+void WeatherHandler::loadBatch(std::mutex &mutex, std::vector<ManifestEntry> files) {
+    for (const ManifestEntry& source : files) {
+        if (interruptRequested) {
+            break;
         }
 
-        std::ifstream file(entry.path().string());
-        if (!file.is_open()) {
+        const auto opening = IngestMetrics::Clock::now();
+        FileReader file(source.path);
+        this->metrics.addStage(IngestStage::Read, IngestMetrics::Clock::now() - opening);
+        if (!file.isOpen()) {
             continue;
         }
+        this->metrics.addFile(source.size);
 
-        std::vector<Measurement> measurements;
-        std::vector<Station> stations;
-
-        std::string line;
-
-        while (std::getline(file, line)) {
-            if (line.empty()) {
-                continue;
-            }
-
-            if (line.find("STATION") != std::string::npos) {
-                continue;
-            }
-
-            measurements.push_back(Measurement::fromCsv(line));
-
-            Station station = Station::fromCsv(line);
-            if (std::find(this->stations.begin(), this->stations.end(), station.id) == this->stations.end()) {
-                this->stations.push_back(station.id);
-                stations.push_back(station);
-            }
-        }
-
-        file.close();
         this->workStations = 0;
         this->workMeasurements = 0;
         std::cout << "\x1B[2J\x1B[H";
 
-        auto bars = generateBars(files.size(), measurements.size(), stations.size(), this->batchCount);
+        auto bars = generateBars(files.size(), this->batchCount);
 
-        if (!this->options->async) {
+        if (!this->options.async) {
             bars->show();
         }
 
-        save(measurements, mutex);
-        save(stations, mutex);
-        this->workFiles++;
+        try {
+            saveFile(file, source, mutex);
+        } catch (const std::exception& e) {
+            // The file's transaction has been rolled back, so it stays marked incomplete
+            std::cerr << "Error: Loading " << source.path << " failed: " << e.what() << std::endl;
+        }
 
         bars->done();
     }
@@ -112,60 +226,756 @@ void WeatherHandler::loadBatch(std::mutex &mutex, std::vector<std::filesystem::d
 /**
  * @brief Processes files in batches and loads them using the provided mutex for synchronization.
  *
- * This method splits the files loaded from the source into smaller batches based on the
- * batch size specified in the `options` parameter. Each batch is then processed sequentially
- * by calling an overloaded `loadBatch` method that handles batch-specific logic. The mutex
- * ensures thread-safe execution while processing batches.
+ * This method splits the files loaded from the source into smaller batches. The number of
+ * batches follows from the batch size specified in the `options` parameter, but the files
+ * are spread over them by bytes with `FileDiscovery::balance`, so every batch carries about
+ * the same amount of data however unevenly the file sizes are distributed. Each batch is then
+ * processed sequentially by calling an overloaded `loadBatch` method that handles
+ * batch-specific logic. The mutex ensures thread-safe execution while processing batches.
+ * The stage timings of the load are written to `options.metrics`.
  *
  * @param mutex A reference to a `std::mutex` used for synchronizing access to shared resources
  * during batch processing.
  */
 void WeatherHandler::loadBatch(std::mutex &mutex) {
-    std::vector<std::filesystem::directory_entry> files = loadFiles();
-    this->batchCount = std::ceil(files.size() / this->options->batchSize);
-    for (size_t start = 0; start < files.size(); start += this->options->batchSize) {
-        size_t end = std::min(start + this->options->batchSize, files.size());
-        std::vector batches(files.begin() + start, files.begin() + end);
-        loadBatch(mutex, batches);
+    InterruptGuard interruptGuard;
+    this->metrics.start();
+    if (TarArchive::isArchive(this->path)) {
+        // An archive is read in one sequential pass, so it is not split into batches
+        loadArchive(mutex);
+        finishMetrics();
+        return;
+    }
+    std::vector<ManifestEntry> files = loadFiles();
+    const size_t batchCount = (files.size() + this->options.batchSize - 1) / this->options.batchSize;
+    std::vector<std::vector<ManifestEntry>> batches = FileDiscovery::balance(std::move(files), batchCount);
+    this->batchCount = batches.size();
+    for (std::vector<ManifestEntry>& batch : batches) {
+        loadBatch(mutex, std::move(batch));
         this->workFiles = 0;
+        if (interruptRequested) {
+            break;
+        }
     }
+    finishMetrics();
 }
 
 /**
- * @brief Asynchronously loads weather data in parallel batches.
+ * @brief Loads weather data through a staged producer/consumer pipeline.
  *
- * The `loadAsync` function divides the available files into batches based on the specified
- * batch size in the `LoadOptions` struct. Each batch is processed in an asynchronous task
- * to improve performance by leveraging concurrency. Progress is visually displayed using
- * a progress bar.
+ * The load is split into three stages:
+ * - The calling thread opens (memory-maps) the files, largest first, and starts prefetching
+ *   their pages. For a tar archive it reads the members one after another instead, see
+ *   `readArchive`, and parses members too large to be held in memory itself. Manifest
+ *   changes for archive members are handed to the writer ahead of their rows.
+ * - Each opened file is parsed by a task on the handler's `ThreadPool`, which hands its rows
+ *   on in chunks of `options.chunkRows`. A file of at least `splitThreshold` bytes is instead
+ *   split into ranges that all pool threads parse at once, see `parseSplit`.
+ * - Files are submitted largest first, as `loadFiles` returns them, and each is taken by
+ *   whichever worker is idle, so the pool schedules them longest-first as they finish rather
+ *   than by a fixed `FileDiscovery::balance` split. The order is only approximate within the
+ *   two files per pool thread that are queued at a time, since a worker runs its own queued
+ *   tasks newest first. Archive members are parsed in archive order.
+ * - Exactly one writer thread owns the database connection and saves each chunk.
  *
- * After all batch operations complete, the function ensures proper synchronization between
- * threads for data integrity. Finally, the progress bar indicates the completion of the
- * loading process.
+ * Parsing therefore scales across the pool's fixed set of threads, however many files there
+ * are, while SQLite only ever sees a single writer and no lock is held around a whole file.
+ * The queue between the parsers and the writer holds one chunk per pool thread, and a parser
+ * waits when it is full, so resident memory is bounded by roughly two chunks per pool thread
+ * regardless of file size or the number of files. Progress is visually displayed using a
+ * progress bar.
  *
- * @param mutex A reference to a mutex used for thread synchronization during batch processing.
+ * The writer writes through a `BulkWriter`, which keeps a transaction open and commits it
+ * each time a file is complete, together with the file's manifest hash, and in between every
+ * `options.commitRows` rows if set. Rows of files still in progress may be part of such a
+ * commit; their files stay marked incomplete until their own checkpoint, and `load --resume`
+ * replaces their rows. If writing fails, the open transaction is rolled back, the error is
+ * reported and the load stops as if interrupted. A file that cannot be read to its end, such
+ * as a truncated gzip file, is reported and never gets its checkpoint, so it stays marked
+ * incomplete and the next `--append` or `--resume` replaces its rows. After Ctrl-C no further
+ * file is started, and the files in flight are parsed, written and committed before the
+ * method returns.
+ *
+ * The stage timings of the load, including how long parsers and writer waited on each other
+ * at the queue, are written to `options.metrics`.
  */
-void WeatherHandler::loadAsync(std::mutex& mutex) {
-    std::vector<std::filesystem::directory_entry> files = loadFiles();
-    std::vector<std::future<void>> futures;
-    this->batchCount = std::ceil(files.size() / this->options->batchSize);
+void WeatherHandler::loadAsync() {
+    InterruptGuard interruptGuard;
+    this->metrics.start();
+    const bool archive = TarArchive::isArchive(this->path);
+    std::vector<ManifestEntry> files;
+    std::map<std::string, ManifestEntry> manifest;
+    if (archive) {
+        // Read before the writer starts, which owns the connection from then on
+        manifest = this->db.getManifest();
+    } else {
+        files = loadFiles();
+    }
+    this->batchCount = 1;
 
-    auto bars = generateBars(files.size(), 0, 0, this->batchCount);
+    std::counting_semaphore<> slots(static_cast<std::ptrdiff_t>(this->pool.size() * 2));
+    BoundedQueue<ParsedFile> parsed(this->pool.size());
+
+    auto bars = generateBars(files.size(), this->batchCount);
     bars->show();
 
-    for (size_t start = 0; start < files.size(); start += this->options->batchSize) {
-        size_t end = std::min(start + this->options->batchSize, files.size());
-        std::vector batches(files.begin() + start, files.begin() + end);
+    std::thread writer([&] {
+        BulkWriter bulk(this->db, this->options.commitRows);
+        try {
+            while (true) {
+                const auto waiting = IngestMetrics::Clock::now();
+                std::optional<ParsedFile> chunk = parsed.pop();
+                this->metrics.addPopWait(IngestMetrics::Clock::now() - waiting);
+                if (!chunk) {
+                    break;
+                }
+
+                {
+                    IngestMetrics::Timer timer(this->metrics, IngestStage::Bind);
+                    if (chunk->record) {
+                        recordSource(chunk->source, *chunk->record);
+                    }
+                    bulk.write(chunk->measurements);
+                    bulk.write(chunk->stations);
+                    if (chunk->complete) {
+                        this->db.updateManifestEntry(chunk->source);
+                    }
+                }
+                this->parseErrors.merge(chunk->errors);
+                this->rejects.add(chunk->source.path, chunk->rejects);
+                if (chunk->complete) {
+                    IngestMetrics::Timer timer(this->metrics, IngestStage::Commit);
+                    bulk.commit();
+                    this->workFiles++;
+                }
+            }
+            IngestMetrics::Timer timer(this->metrics, IngestStage::Commit);
+            bulk.commit();
+        } catch (const std::exception& e) {
+            bulk.rollback();
+            std::cerr << "Error: Writing to the database failed, rolled back to the last commit: " << e.what() << std::endl;
+            // Stops reading further files; parsers drop their chunks once the queue is closed
+            interruptRequested = 1;
+            parsed.close();
+        }
+        this->rejects.flush();
+    });
+
+    const auto handOver = [&](ParsedFile& chunk) {
+        const auto waiting = IngestMetrics::Clock::now();
+        parsed.push(std::move(chunk));
+        this->metrics.addPushWait(IngestMetrics::Clock::now() - waiting);
+    };
 
-        futures.push_back(std::async(std::launch::async, [this, &mutex, batches]() {
-            loadBatch(mutex, batches);
-        }));
+    const auto submit = [&](const std::shared_ptr<FileReader>& file, const ManifestEntry& source) {
+        slots.acquire();
+        this->pool.submit([this, file, source, &handOver, &slots] {
+            SlotGuard slot(slots);
+            try {
+                parseFile(*file, source, handOver);
+            } catch (const std::exception& e) {
+                // Without its final chunk the file stays marked incomplete and is loaded again
+                std::cerr << "Error: Loading " << source.path << " failed: " << e.what() << std::endl;
+            }
+        });
+    };
+
+    if (archive) {
+        readArchive(manifest, [&](const std::shared_ptr<FileReader>& file, ManifestEntry& source, SourceStatus status, bool streamed) {
+            ParsedFile record;
+            record.source = source;
+            record.record = status;
+            handOver(record);
+            if (file == nullptr) {
+                return;
+            }
+            if (streamed) {
+                parseFile(*file, source, handOver);
+            } else {
+                submit(file, source);
+            }
+        });
     }
-    for (auto& future : futures) {
-        future.get();
+    for (const ManifestEntry& source : files) {
+        if (interruptRequested) {
+            break;
+        }
+        const auto opening = IngestMetrics::Clock::now();
+        auto file = std::make_shared<FileReader>(source.path);
+        this->metrics.addStage(IngestStage::Read, IngestMetrics::Clock::now() - opening);
+        if (!file->isOpen()) {
+            continue;
+        }
+        this->metrics.addFile(source.size);
+        if (file->contents().size() >= splitThreshold) {
+            // One very large file is parsed by all pool threads instead of a single task
+            parseSplit(*file, source, handOver);
+            continue;
+        }
+        file->prefetch();
+        submit(file, source);
     }
 
+    this->pool.wait();
+    parsed.close();
+    writer.join();
+
+    this->workBatches = this->batchCount;
     bars->done();
+    finishMetrics();
+}
+
+/**
+ * @brief Parses the input files on the pool and discards the rows, to benchmark the parser alone.
+ *
+ * Files are found and opened as for a load and parsed by the same `parseFile` and
+ * `parseSplit`, with up to two files in flight per pool thread, but the chunks are dropped
+ * instead of being written. Nothing is stored, not even the manifest, so every file below the
+ * path is parsed, up to `options.limit`. Parse errors and rejected rows are counted as usual,
+ * and the read and parse timings are written to `options.metrics`. Tar archives are not
+ * supported.
+ *
+ * @return The parsed rows, including rejected ones, the input bytes, and the time taken.
+ */
+Throughput WeatherHandler::parseOnly() {
+    InterruptGuard interruptGuard;
+    Throughput throughput;
+    if (TarArchive::isArchive(this->path)) {
+        std::cerr << "Error: --parse-only does not support archives." << std::endl;
+        return throughput;
+    }
+    this->metrics.start();
+
+    std::vector<ManifestEntry> files;
+    {
+        IngestMetrics::Timer timer(this->metrics, IngestStage::Discovery);
+        files = FileDiscovery::discover(this->path, this->pool, isCsvFile);
+        std::sort(files.begin(), files.end(), [](const ManifestEntry& a, const ManifestEntry& b) {
+            return a.path < b.path;
+        });
+        if (files.size() > static_cast<size_t>(std::max(this->options.limit, 0))) {
+            files.resize(std::max(this->options.limit, 0));
+        }
+        FileDiscovery::sortLargestFirst(files);
+    }
+
+    std::atomic<size_t> rows = 0;
+    std::mutex mutex;
+    const auto discard = [&](ParsedFile& chunk) {
+        rows += chunk.measurements.size() + chunk.rejects.size();
+        std::lock_guard lock(mutex);
+        this->parseErrors.merge(chunk.errors);
+        this->rejects.add(chunk.source.path, chunk.rejects);
+    };
+
+    std::counting_semaphore<> slots(static_cast<std::ptrdiff_t>(this->pool.size() * 2));
+    const auto start = std::chrono::steady_clock::now();
+    for (const ManifestEntry& source : files) {
+        if (interruptRequested) {
+            break;
+        }
+        const auto opening = IngestMetrics::Clock::now();
+        auto file = std::make_shared<FileReader>(source.path);
+        this->metrics.addStage(IngestStage::Read, IngestMetrics::Clock::now() - opening);
+        if (!file->isOpen()) {
+            continue;
+        }
+        this->metrics.addFile(source.size);
+        throughput.bytes += source.size;
+        if (file->contents().size() >= splitThreshold) {
+            parseSplit(*file, source, discard);
+            continue;
+        }
+        slots.acquire();
+        this->pool.submit([this, file, source, &discard, &slots] {
+            SlotGuard slot(slots);
+            parseFile(*file, source, discard);
+        });
+    }
+    this->pool.wait();
+    this->rejects.flush();
+
+    throughput.rows = rows;
+    throughput.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    finishMetrics();
+    return throughput;
+}
+
+/**
+ * @brief Writes one pre-parsed batch to the database repeatedly, to benchmark storage alone.
+ *
+ * The first chunk of the first input file is parsed into memory once, outside the timing.
+ * It is then inserted `rounds` times through a `BulkWriter`, exactly as the loaders write a
+ * chunk: committed every `options.commitRows` rows if set, and otherwise once per round. The
+ * rows go to the scratch database opened for `options.replay`, never to weather.db; it is
+ * deleted again with the handler.
+ *
+ * @param rounds The number of times the batch is written.
+ * @return The inserted rows and the time the inserts took.
+ */
+Throughput WeatherHandler::replay(size_t rounds) {
+    Throughput throughput;
+    if (!this->options.replay) {
+        std::cerr << "Error: replay needs a handler created with the replay option." << std::endl;
+        return throughput;
+    }
+    if (TarArchive::isArchive(this->path)) {
+        std::cerr << "Error: --replay does not support archives." << std::endl;
+        return throughput;
+    }
+
+    std::vector<ManifestEntry> files = FileDiscovery::discover(this->path, this->pool, isCsvFile);
+    std::optional<ParsedFile> batch;
+    for (const ManifestEntry& source : files) {
+        FileReader file(source.path);
+        if (!file.isOpen()) {
+            continue;
+        }
+        parseFile(file, source, [&](ParsedFile& chunk) {
+            if (!batch && !chunk.measurements.empty()) {
+                batch = std::move(chunk);
+            }
+        });
+        if (batch) {
+            break;
+        }
+    }
+    if (!batch) {
+        std::cerr << "Error: No rows to replay found in " << this->path << std::endl;
+        return throughput;
+    }
+
+    std::ranges::fill(batch->measurements.file, 0);
+    const auto start = std::chrono::steady_clock::now();
+    BulkWriter bulk(this->db, this->options.commitRows);
+    for (size_t round = 0; round < rounds; ++round) {
+        bulk.write(batch->measurements);
+        if (this->options.commitRows == 0) {
+            bulk.commit();
+        }
+    }
+    bulk.commit();
+
+    throughput.rows = batch->measurements.size() * rounds;
+    throughput.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return throughput;
+}
+
+/**
+ * @brief Loads the members of a tar archive one after another.
+ *
+ * The archive is read in a single sequential pass by `readArchive` and each member is
+ * recorded in the manifest, then parsed and saved as soon as it has been read, in its own
+ * transaction.
+ *
+ * @param mutex A reference to a `std::mutex` used to synchronize access during saving.
+ */
+void WeatherHandler::loadArchive(std::mutex& mutex) {
+    auto bars = generateBars(0, 1);
+    bars->show();
+
+    readArchive(this->db.getManifest(), [&](const std::shared_ptr<FileReader>& file, ManifestEntry& source, SourceStatus status, bool) {
+        recordSource(source, status);
+        if (file != nullptr) {
+            saveFile(*file, source, mutex);
+        }
+    });
+
+    this->workBatches++;
+    bars->done();
+}
+
+/**
+ * @brief Reads the CSV members of the tar archive at `path` and hands each one to `consume`.
+ *
+ * NOAA publishes global-hourly as one tarball per year, so reading the archive directly
+ * replaces thousands of small-file opens with one sequential read, without unpacking anything
+ * to disk. Each member is compared with the manifest as "<archive>/<member>", with the size
+ * and modification time from its tar header, so `load --append` skips unchanged members;
+ * their contents are then skipped, not read. At most `options.limit` members are loaded, and
+ * reading stops early after Ctrl-C.
+ *
+ * Members of up to `archiveMemberInMemory` bytes are read into memory, so they can be parsed
+ * on another thread while the archive is read on; a member whose modification time changed is
+ * hashed from those bytes. Larger members are streamed from the archive through a bounded
+ * reader that `consume` must parse before it returns; they cannot be hashed ahead of parsing,
+ * so a changed modification time always reloads them.
+ *
+ * If the archive turns out to be damaged, the error is reported and reading stops; the member
+ * being read is never handed on as complete.
+ *
+ * Nothing is written to the database here: `consume` records each member with `recordSource`,
+ * on whichever thread owns the connection. New members get ids following the largest one in
+ * `manifest`, since no other entries are added during the load.
+ *
+ * @param manifest The manifest as stored before this load.
+ * @param consume Receives each member that is not unchanged.
+ */
+void WeatherHandler::readArchive(const std::map<std::string, ManifestEntry>& manifest, const ArchiveConsumer& consume) {
+    TarArchive archive(this->path);
+    if (!archive.isOpen()) {
+        std::cerr << "Error: Cannot open archive " << this->path << std::endl;
+        return;
+    }
+
+    int64_t lastId = 0;
+    for (const auto& [path, entry] : manifest) {
+        lastId = std::max(lastId, entry.id);
+    }
+
+    int count = 0;
+    TarMember member;
+    try {
+        while (count < this->options.limit && !interruptRequested && archive.next(member)) {
+            if (!isCsvFile(member.name)) {
+                continue;
+            }
+
+            ManifestEntry source;
+            source.path = (std::filesystem::path(this->path) / member.name).string();
+            source.size = static_cast<int64_t>(member.size);
+            source.mtime = member.mtime;
+
+            if (member.size > archiveMemberInMemory) {
+                SourceStatus status;
+                {
+                    IngestMetrics::Timer timer(this->metrics, IngestStage::Dedupe);
+                    status = checkSource(manifest, source, [] { return std::string(); });
+                }
+                if (status == SourceStatus::Unchanged) {
+                    continue;
+                }
+                if (status == SourceStatus::New) {
+                    source.id = ++lastId;
+                }
+                this->metrics.addFile(member.size);
+                consume(std::make_shared<FileReader>([&archive](char* output, size_t size) {
+                    return archive.readSome(output, size);
+                }), source, status, true);
+                count++;
+                continue;
+            }
+
+            std::vector<char> contents;
+            bool contentsRead = false;
+            const auto hashMember = [&] {
+                IngestMetrics::Timer timer(this->metrics, IngestStage::Read);
+                if (!archive.read(contents)) {
+                    throw std::runtime_error("Truncated tar archive.");
+                }
+                contentsRead = true;
+                return FileManifest::hashContents(std::string_view(contents.data(), contents.size()));
+            };
+
+            SourceStatus status;
+            {
+                IngestMetrics::Timer timer(this->metrics, IngestStage::Dedupe);
+                status = checkSource(manifest, source, hashMember);
+            }
+            if (status == SourceStatus::Unchanged) {
+                continue;
+            }
+            if (status == SourceStatus::Touched) {
+                consume(nullptr, source, status, false);
+                continue;
+            }
+            if (status == SourceStatus::New) {
+                source.id = ++lastId;
+            }
+
+            if (!contentsRead) {
+                IngestMetrics::Timer timer(this->metrics, IngestStage::Read);
+                if (!archive.read(contents)) {
+                    break;
+                }
+            }
+            this->metrics.addFile(member.size);
+            consume(std::make_shared<FileReader>(std::move(contents)), source, status, false);
+            count++;
+        }
+    } catch (const std::exception& e) {
+        // A damaged archive cannot be read on past the error; the member stays incomplete
+        std::cerr << "Error: Reading " << this->path << " failed: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief Parses one file and saves it through a `BulkWriter`, whose last transaction is
+ *        committed together with the file's manifest entry.
+ *
+ * By default the whole file is one transaction, so an interrupted load never leaves a file
+ * half stored. With `options.commitRows` set, rows are also committed in between; a file
+ * interrupted after such a commit stays marked incomplete and `load --resume` replaces its
+ * rows. Files of at least `splitThreshold` bytes are parsed in parallel ranges by `parseSplit`.
+ *
+ * @param file The opened file.
+ * @param source The manifest entry of the file.
+ * @param mutex A reference to a `std::mutex` used to synchronize access during saving.
+ */
+void WeatherHandler::saveFile(FileReader& file, const ManifestEntry& source, std::mutex& mutex) {
+    BulkWriter bulk(this->db, this->options.commitRows);
+    const auto flush = [&](ParsedFile& chunk) {
+        IngestMetrics::Timer timer(this->metrics, IngestStage::Bind);
+        save(bulk, chunk.measurements, mutex);
+        save(bulk, chunk.stations, mutex);
+
+        std::lock_guard lock(mutex);
+        this->parseErrors.merge(chunk.errors);
+        this->rejects.add(chunk.source.path, chunk.rejects);
+        if (chunk.complete) {
+            this->db.updateManifestEntry(chunk.source);
+        }
+    };
+
+    if (file.contents().size() >= splitThreshold) {
+        parseSplit(file, source, flush);
+    } else {
+        parseFile(file, source, flush);
+    }
+    {
+        IngestMetrics::Timer timer(this->metrics, IngestStage::Commit);
+        bulk.commit();
+    }
+    this->rejects.flush();
+    this->workFiles++;
+}
+
+/**
+ * @brief Returns the conversion failures counted across every file loaded so far.
+ *
+ * The counters are filled while loading instead of logging each failure, so the
+ * caller can print a single summary once the load has finished.
+ *
+ * @return The aggregated per-field parse error counters.
+ */
+const ParseErrors& WeatherHandler::getParseErrors() const {
+    return this->parseErrors;
+}
+
+/**
+ * @brief Returns the rows rejected across every file loaded so far, for the load summary.
+ */
+const RejectSink& WeatherHandler::getRejects() const {
+    return this->rejects;
+}
+
+/**
+ * @brief Returns the stage timings and volumes of the last load.
+ */
+const IngestMetrics& WeatherHandler::getMetrics() const {
+    return this->metrics;
+}
+
+/**
+ * @brief Returns the worker pool, so further parallel work such as queries or aggregations
+ * runs on the same bounded set of threads as the loader.
+ *
+ * @return The handler's thread pool.
+ */
+ThreadPool& WeatherHandler::getPool() {
+    return this->pool;
+}
+
+/**
+ * @brief Reports whether the last load was stopped early with Ctrl-C.
+ *
+ * Every file that was started has been committed in that case; the remaining ones can be
+ * loaded with `load --resume`.
+ */
+bool WeatherHandler::wasInterrupted() const {
+    return interruptRequested != 0;
+}
+
+/**
+ * @brief Parses every data line of an opened file into measurements and new stations.
+ *
+ * Each line is tokenized once and the resulting fields feed both the measurement and the
+ * station builders. A station is only built when the shared `StationRegistry` has not seen
+ * its id before. Only the first line is checked for a header; it is resolved into the file's
+ * `ColumnPlan` once, and every data line is then read by the plan's indexes, without any
+ * search. Without a header NOAA's standard layout is assumed. The optional sections of each
+ * row are kept raw, and only the families enabled in the load options are decoded. The
+ * categorical fields are encoded with the database's shared dictionaries. Conversion failures
+ * are counted in the chunk's error counters. Rows that cannot be stored are not added to the
+ * measurements but kept in the chunk's `rejects` with their line number, counted from the
+ * first line `file` serves.
+ *
+ * Rows are collected into a chunk that is passed to `flush` whenever it reaches
+ * `options.chunkRows` measurements, and once more with `complete` set at the end of the file.
+ * `flush` may move from the chunk; it is cleared before parsing continues. Every measurement
+ * refers to the manifest id of `source`, and the content hash is computed on the fly from
+ * the lines read and handed over with the last chunk.
+ *
+ * The time spent between flushes is counted as parse time of the calling thread; the time
+ * `flush` takes is not.
+ *
+ * The method touches no database state and is safe to call from several threads at once.
+ *
+ * @param file The opened file to parse.
+ * @param source The manifest entry of the file.
+ * @param flush Receives each chunk of measurements, newly seen stations, and error counters.
+ * @param header The file's header line, for readers that serve a range without it.
+ */
+void WeatherHandler::parseFile(FileReader& file, const ManifestEntry& source, const std::function<void(ParsedFile&)>& flush, std::string_view header) {
+    const size_t chunkRows = this->options.chunkRows;
+    ContentHash hash;
+    std::string_view line;
+    std::vector<std::string_view> fields;
+    ColumnPlan plan;
+
+    if (!header.empty()) {
+        plan = ColumnPlan::fromHeader(header, this->sectionDecoders);
+    }
+
+    size_t lineNumber = 0;
+    size_t flushedLines = 0;
+
+    ParsedFile chunk;
+    chunk.source = source;
+    chunk.measurements.reserve(chunkRows);
+    auto parsing = IngestMetrics::Clock::now();
+
+    while (file.nextLine(line)) {
+        hash.update(line);
+        lineNumber++;
+        if (line.empty()) {
+            continue;
+        }
+
+        if (lineNumber == 1 && ColumnPlan::isHeader(line)) {
+            plan = ColumnPlan::fromHeader(line, this->sectionDecoders);
+            continue;
+        }
+
+        CsvTokenizer::tokenize(line, fields);
+        const std::optional<FieldError> rejected = chunk.measurements.append(fields, plan, this->db.getDictionaries(), source.id, chunk.errors);
+        if (rejected) {
+            if (line.ends_with('\r')) {
+                line.remove_suffix(1);
+            }
+            chunk.rejects.push_back({lineNumber, *rejected, std::string(line)});
+            continue;
+        }
+
+        if (this->stations.insert(plan.field(fields, CsvColumn::Station))) {
+            chunk.stations.push_back(Station::fromCsv(fields, plan, chunk.errors));
+        }
+
+        if (chunkRows > 0 && chunk.measurements.size() >= chunkRows) {
+            chunk.lines = lineNumber - flushedLines;
+            flushedLines = lineNumber;
+            this->metrics.addParsed(chunk.measurements.size(), chunk.rejects.size(), IngestMetrics::Clock::now() - parsing);
+            flush(chunk);
+            chunk = ParsedFile();
+            chunk.source = source;
+            chunk.measurements.reserve(chunkRows);
+            parsing = IngestMetrics::Clock::now();
+        }
+    }
+
+    chunk.complete = true;
+    chunk.lines = lineNumber - flushedLines;
+    chunk.source.hash = hash.hex();
+    this->metrics.addParsed(chunk.measurements.size(), chunk.rejects.size(), IngestMetrics::Clock::now() - parsing);
+    flush(chunk);
+}
+
+/**
+ * @brief Parses one large mapped file on several pool threads at once.
+ *
+ * The mapping is cut into ranges of `splitSize` bytes on record boundaries by
+ * `FileSplitter`, and each range is parsed by `parseFile` in its own pool task with the
+ * file's header line, without its line terminator, so every range resolves the same column
+ * plan as the whole file. Ranges are parsed a few ahead of the one being handed on, and their
+ * chunks are passed to `flush` in input order. The content hash runs in one more task over
+ * the whole file and is handed over with a final empty chunk that has `complete` set, as
+ * `parseFile` would. The line numbers of rejected rows are shifted by the lines of the ranges
+ * before them, so they count from the start of the file. If `flush` or a range throws, the
+ * tasks still in flight are waited for before the exception propagates.
+ *
+ * Must not be called from a task running on the pool.
+ *
+ * @param file A mapped reader of the file.
+ * @param source The manifest entry of the file.
+ * @param flush Receives each chunk of measurements, newly seen stations, and error counters.
+ */
+void WeatherHandler::parseSplit(FileReader& file, const ManifestEntry& source, const std::function<void(ParsedFile&)>& flush) {
+    const std::string_view contents = file.contents();
+    std::string_view header = contents.substr(0, contents.find('\n'));
+    if (header.ends_with('\r')) {
+        header.remove_suffix(1);
+    }
+
+    std::future<std::string> hash = this->pool.async([&file, contents] {
+        FileReader all(file, contents);
+        ContentHash content;
+        std::string_view line;
+        while (all.nextLine(line)) {
+            content.update(line);
+        }
+        return content.hex();
+    });
+
+    std::deque<std::future<std::vector<ParsedFile>>> window;
+    try {
+        const std::vector<std::string_view> ranges = FileSplitter::split(contents, splitSize, this->pool);
+        size_t next = 0;
+        size_t firstLine = 0;
+
+        const auto parseRange = [&](std::string_view range) {
+            return this->pool.async([this, &file, &source, range, header] {
+                std::vector<ParsedFile> chunks;
+                FileReader reader(file, range);
+                parseFile(reader, source, [&](ParsedFile& chunk) {
+                    chunks.push_back(std::move(chunk));
+                }, header);
+                return chunks;
+            });
+        };
+
+        while (next < ranges.size() || !window.empty()) {
+            while (next < ranges.size() && window.size() <= this->pool.size()) {
+                window.push_back(parseRange(ranges[next++]));
+            }
+
+            std::vector<ParsedFile> chunks = window.front().get();
+            window.pop_front();
+            for (ParsedFile& chunk : chunks) {
+                for (RejectedRow& row : chunk.rejects) {
+                    row.line += firstLine;
+                }
+                firstLine += chunk.lines;
+                chunk.complete = false;
+                flush(chunk);
+            }
+        }
+    } catch (...) {
+        // The queued tasks read the caller's mapping and `source`, which are released as soon
+        // as the exception leaves; a future of the pool does not wait for its task when dropped
+        for (const std::future<std::vector<ParsedFile>>& pending : window) {
+            if (pending.valid()) {
+                pending.wait();
+            }
+        }
+        hash.wait();
+        throw;
+    }
+
+    ParsedFile last;
+    last.complete = true;
+    last.source = source;
+    last.source.hash = hash.get();
+    flush(last);
+}
+
+/**
+ * @brief Stops the load's metrics and writes them to `options.metrics`, if set.
+ */
+void WeatherHandler::finishMetrics() {
+    this->metrics.finish();
+    if (!this->options.metrics.empty()) {
+        this->metrics.write(this->options.metrics);
+    }
 }
 
 /**
@@ -173,50 +983,155 @@ void WeatherHandler::loadAsync(std::mutex& mutex) {
  *
  * This destructor ensures proper cleanup of the WeatherHandler object by
  * deallocating any internal resources, including the database handler or
- * other dynamically allocated components, if necessary.
+ * other dynamically allocated components, if necessary. The scratch database of a replay
+ * is deleted.
  */
-WeatherHandler::~WeatherHandler() = default;
+WeatherHandler::~WeatherHandler() {
+    if (this->options.replay) {
+        // Unlinking the still open file works on POSIX; elsewhere the next replay removes it
+        std::error_code ignored;
+        std::filesystem::remove(replayDatabase(), ignored);
+    }
+}
 
 /**
- * @brief Loads and filters a list of files from the specified directory path.
+ * @brief Finds the files to load below the specified directory path.
+ *
+ * The directory at `path` is searched recursively, e.g. through one subdirectory per year,
+ * by `FileDiscovery::discover` on the worker pool, keeping regular files with a `.csv`,
+ * `.csv.gz` or `.csv.zst` extension. The candidates are taken in path order, so `limit`
+ * selects the same files on every run, and each one is checked against the manifest by
+ * `registerSource`; files that were loaded before and have not changed are skipped. It limits
+ * the number of files added to the result based on the `limit` value specified in the
+ * `options` member.
  *
- * This function iterates through the directory specified by the `path` member, filtering
- * files based on certain criteria, such as being a regular file with a `.csv` extension.
- * It limits the number of files added to the result based on the `limit` value specified
- * in the `options` member. This ensures only a restricted number of relevant files are loaded.
+ * The result is ordered largest file first, the order in which the loaders should start them.
  *
- * @return A vector of `std::filesystem::directory_entry` objects representing the filtered files.
+ * @return The manifest entries of the files to load.
  */
-std::vector<std::filesystem::directory_entry> WeatherHandler::loadFiles() const {
+std::vector<ManifestEntry> WeatherHandler::loadFiles() {
+    std::vector<ManifestEntry> candidates;
+    {
+        IngestMetrics::Timer timer(this->metrics, IngestStage::Discovery);
+        candidates = FileDiscovery::discover(this->path, this->pool, isCsvFile);
+        std::sort(candidates.begin(), candidates.end(), [](const ManifestEntry& a, const ManifestEntry& b) {
+            return a.path < b.path;
+        });
+    }
+
+    IngestMetrics::Timer timer(this->metrics, IngestStage::Dedupe);
+    const std::map<std::string, ManifestEntry> manifest = this->db.getManifest();
     int count = 0;
-    std::vector<std::filesystem::directory_entry> files;
-    for (const auto& entry : std::filesystem::directory_iterator(path)) {
-        if (count >= options->limit) {
+    std::vector<ManifestEntry> files;
+    for (ManifestEntry& source : candidates) {
+        if (count >= options.limit) {
             break;
         }
-        if (entry.is_regular_file() && entry.path().extension() == ".csv") {
-            files.push_back(entry);
-            count++;
+        if (!registerSource(manifest, source)) {
+            continue;
         }
+        files.push_back(std::move(source));
+        count++;
     }
 
+    FileDiscovery::sortLargestFirst(files);
     return files;
 }
 
 /**
- * @brief Saves a collection of measurements to the database in a thread-safe manner.
+ * @brief Records a file in the manifest and decides whether it has to be loaded.
+ *
+ * - A file missing from the manifest is added and loaded.
+ * - A completely loaded file with the recorded size and modification time is skipped.
+ * - Otherwise the file is hashed; if the content is unchanged only its new modification time
+ *   is recorded and the file is skipped.
+ * - A changed file, or one whose earlier load never completed, has its measurements deleted
+ *   and is loaded again.
+ *
+ * @param manifest The manifest as stored before this load.
+ * @param source The file as found on disk; receives its manifest id.
+ * @return True if the file has to be loaded.
+ */
+bool WeatherHandler::registerSource(const std::map<std::string, ManifestEntry>& manifest, ManifestEntry& source) {
+    const SourceStatus status = checkSource(manifest, source, [&] {
+        return FileManifest::hash(source.path);
+    });
+    recordSource(source, status);
+    return status == SourceStatus::Changed || status == SourceStatus::New;
+}
+
+/**
+ * @brief Compares a file with the manifest without changing the database.
+ *
+ * The file is only hashed if its size or modification time differ from a complete entry.
+ *
+ * @param manifest The manifest as stored before this load.
+ * @param source The file as found; receives its manifest id if it has one, and for a touched
+ *               file the stored hash.
+ * @param hash Computes the content hash of the file; may return an empty string if the file
+ *             cannot be hashed, which makes it count as changed.
+ * @return The status of the file.
+ */
+SourceStatus WeatherHandler::checkSource(const std::map<std::string, ManifestEntry>& manifest, ManifestEntry& source, const std::function<std::string()>& hash) const {
+    const auto stored = manifest.find(source.path);
+    if (stored == manifest.end()) {
+        return SourceStatus::New;
+    }
+
+    source.id = stored->second.id;
+    if (FileManifest::unchanged(stored->second, source)) {
+        return SourceStatus::Unchanged;
+    }
+
+    if (!stored->second.hash.empty() && hash() == stored->second.hash) {
+        source.hash = stored->second.hash;
+        return SourceStatus::Touched;
+    }
+    return SourceStatus::Changed;
+}
+
+/**
+ * @brief Applies the status of a file to the manifest.
+ *
+ * A new file is inserted, with the id already in `source` if it has one; a touched file gets
+ * its new modification time; a changed file has its measurements deleted and its entry reset
+ * to incomplete.
+ *
+ * @param source The file; receives the id of a newly inserted entry.
+ * @param status The status from `checkSource`.
+ */
+void WeatherHandler::recordSource(ManifestEntry& source, SourceStatus status) {
+    switch (status) {
+        case SourceStatus::Unchanged:
+            break;
+        case SourceStatus::Touched:
+            this->db.updateManifestEntry(source);
+            break;
+        case SourceStatus::Changed:
+            this->db.deleteMeasurementsOfFile(source.id);
+            this->db.updateManifestEntry(source);
+            break;
+        case SourceStatus::New:
+            source.id = this->db.insertManifestEntry(source);
+            break;
+    }
+}
+
+/**
+ * @brief Saves a batch of measurements to the database in a thread-safe manner.
  *
  * This function ensures thread-safety by acquiring a lock on the provided mutex before
- * inserting the given vector of `Measurement` objects into the database. It also increments
- * the `workMeasurements` counter to track successful operations.
+ * writing the rows of the given `MeasurementBatch` through the file's `BulkWriter`. It also
+ * adds the number of saved rows to the `workMeasurements` counter.
  *
- * @param measurements A reference to a vector containing `Measurement` objects to be saved.
+ * @param bulk The writer of the file being saved.
+ * @param measurements A reference to the batch of parsed rows to be saved.
  * @param mutex A reference to a mutex used to ensure exclusive access to shared resources.
  */
-void WeatherHandler::save(std::vector<Measurement> &measurements, std::mutex &mutex) {
+void WeatherHandler::save(BulkWriter &bulk, MeasurementBatch &measurements, std::mutex &mutex) {
     std::lock_guard lock(mutex);
-    this->db.insertMeasurements(measurements);
-    this->workMeasurements++;
+    bulk.write(measurements);
+    this->workMeasurements += measurements.size();
 
 }
 
@@ -224,15 +1139,16 @@ void WeatherHandler::save(std::vector<Measurement> &measurements, std::mutex &mu
  * @brief Saves a collection of station records to the database in a thread-safe manner.
  *
  * This method locks the provided mutex to ensure thread-safe access to shared resources
- * and calls the database handler to insert the provided station data. It also updates
+ * and writes the provided station data through the file's `BulkWriter`. It also updates
  * the internal counter for the number of stations processed.
  *
+ * @param bulk The writer of the file being saved.
  * @param stations A reference to a vector of Station objects to be saved to the database.
  * @param mutex A reference to a std::mutex object used to ensure thread safety during data insertion.
  */
-void WeatherHandler::save(std::vector<Station> &stations, std::mutex &mutex) {
+void WeatherHandler::save(BulkWriter &bulk, std::vector<Station> &stations, std::mutex &mutex) {
     std::lock_guard lock(mutex);
-    this->db.insertStations(stations);
+    bulk.write(stations);
     this->workStations += stations.size();
 }
 
@@ -244,14 +1160,38 @@ void WeatherHandler::save(std::vector<Station> &stations, std::mutex &mutex) {
  * It can also include additional progress bars for batch processing if certain
  * options are enabled.
  *
- * @param files The total number of files to be processed.
- * @param measurements The total number of measurement entities to be saved.
- * @param stations The total number of station entities to be saved.
+ * Rows are saved in chunks while a file is still being parsed, so the number of
+ * measurements and stations is not known up front; they are shown as counters. The same
+ * applies to the files of a tar archive, which are only discovered while it is read.
+ *
+ * @param files The total number of files to be processed, or 0 if it is not known.
  * @param batches The total number of batches to be processed.
  * @return A shared pointer to a `barkeep::CompositeDisplay` containing the relevant progress bars.
  */
-std::shared_ptr<barkeep::CompositeDisplay> WeatherHandler::generateBars(int files, int measurements, int stations, int batches) {
-    if (this->options->async) {
+std::shared_ptr<barkeep::CompositeDisplay> WeatherHandler::generateBars(int files, int batches) {
+    // barkeep divides by the totals, so an empty stage is shown as a bar of one
+    batches = std::max(batches, 1);
+
+    std::shared_ptr<barkeep::BaseDisplay> fileBar;
+    if (files > 0) {
+        fileBar = barkeep::ProgressBar(&this->workFiles, {
+            .total = files,
+            .message = "Load files",
+            .speed = 1,
+            .speed_unit = "files/s",
+            .style = barkeep::Rich,
+            .show = false,
+        });
+    } else {
+        fileBar = barkeep::Counter(&this->workFiles, {
+            .message = "Load files",
+            .speed = 1,
+            .speed_unit = "files/s",
+            .show = false,
+        });
+    }
+
+    if (this->options.async) {
         return barkeep::Composite(
                 {barkeep::ProgressBar(&this->workBatches, {
                 .total = batches,
@@ -261,15 +1201,8 @@ std::shared_ptr<barkeep::CompositeDisplay> WeatherHandler::generateBars(int file
                 .style = barkeep::Rich,
                 .show = false,
                 }),
-              barkeep::ProgressBar(&this->workFiles, {
-                    .total = files,
-                    .message = "Load files",
-                    .speed = 1,
-                  .speed_unit = "files/s",
-                    .style = barkeep::Rich,
-                    .show = false,
-                }),},"\n");
-    }else if (this->options->batch) {
+              fileBar,},"\n");
+    }else if (this->options.batch) {
         return barkeep::Composite(
         {barkeep::ProgressBar(&this->workBatches, {
         .total = batches,
@@ -279,54 +1212,32 @@ std::shared_ptr<barkeep::CompositeDisplay> WeatherHandler::generateBars(int file
         .style = barkeep::Rich,
         .show = false,
         }),
-      barkeep::ProgressBar(&this->workFiles, {
-            .total = files,
-            .message = "Load files",
-            .speed = 1,
-          .speed_unit = "files/s",
-            .style = barkeep::Rich,
-            .show = false,
-        }),
-        barkeep::ProgressBar(&this->workMeasurements, {
-            .total = measurements,
+      fileBar,
+        barkeep::Counter(&this->workMeasurements, {
             .message = "Save measurements",
             .speed = 1,
             .speed_unit = "entities/s",
-            .style = barkeep::Rich,
             .show = false,
         }),
-        barkeep::ProgressBar(&this->workStations, {
-            .total =stations,
+        barkeep::Counter(&this->workStations, {
             .message = "Save stations",
             .speed = 1,
             .speed_unit = "entities/s",
-            .style = barkeep::Rich,
             .show = false,
         })},"\n");
     }else {
         return barkeep::Composite(
-      {barkeep::ProgressBar(&this->workFiles, {
-            .total = files,
-            .message = "Load files",
-            .speed = 1,
-          .speed_unit = "files/s",
-            .style = barkeep::Rich,
-            .show = false,
-        }),
-        barkeep::ProgressBar(&this->workMeasurements, {
-            .total = measurements,
+      {fileBar,
+        barkeep::Counter(&this->workMeasurements, {
             .message = "Save measurements",
             .speed = 1,
             .speed_unit = "entities/s",
-            .style = barkeep::Rich,
             .show = false,
         }),
-        barkeep::ProgressBar(&this->workStations, {
-            .total =stations,
+        barkeep::Counter(&this->workStations, {
             .message = "Save stations",
             .speed = 1,
             .speed_unit = "entities/s",
-            .style = barkeep::Rich,
             .show = false,
         })},"\n");
     }
@@ -1,7 +1,15 @@
 ﻿#ifndef WEATHERHANDLER_H
 #define WEATHERHANDLER_H
+#include <optional>
+
 #include "barkeep.h"
+#include "BulkWriter.h"
+#include "IngestMetrics.h"
 #include "SQLiteHandler.h"
+#include "RejectSink.h"
+#include "StationRegistry.h"
+#include "FileReader.h"
+#include "ThreadPool.h"
 
 /**
  * @struct LoadOptions
@@ -9,13 +17,86 @@
  *
  * LoadOptions struct defines various parameters to control the behavior of data loading,
  * including limits on the number of files, batch sizes, and whether asynchronous or batch
- * operations should be performed.
+ * operations should be performed. `sections` lists the optional NOAA section families to
+ * decode at ingest, e.g. "AA" or "GA1-GA6". `threads` sizes the worker pool; 0 uses one
+ * thread per hardware thread. `chunkRows` is the number of rows parsed before they are
+ * flushed to the database; 0 keeps whole files in memory. `append` keeps the existing
+ * database and loads only files that are new or changed since they were last loaded.
+ * `commitRows` is the number of rows after which the database transaction is committed; 0
+ * commits once per file. `rejects` is the CSV file rows that cannot be stored are written to.
+ * `metrics` is the JSON file the stage timings of each load are written to; empty, the
+ * default, writes none.
+ * `parseOnly` leaves the database untouched, for benchmarking the parser with `parseOnly()`.
+ * `replay` opens a scratch database in the temporary directory instead of weather.db, for
+ * benchmarking storage with `replay()`.
  */
 struct LoadOptions {
     int limit;
     int batchSize;
     bool async;
     bool batch;
+    std::vector<std::string> sections;
+    size_t threads = 0;
+    size_t chunkRows = 10000;
+    bool append = false;
+    size_t commitRows = 0;
+    std::string rejects = "rejects.csv";
+    std::string metrics;
+    bool parseOnly = false;
+    bool replay = false;
+};
+
+/**
+ * @struct Throughput
+ * @brief The amount of work a benchmark run did and the wall-clock time it took.
+ *
+ * `bytes` counts input bytes as stored on disk, i.e. compressed for compressed files.
+ */
+struct Throughput {
+    size_t rows = 0;
+    size_t bytes = 0;
+    double seconds = 0;
+};
+
+/**
+ * @enum SourceStatus
+ * @brief How a source file found for loading compares with its manifest entry.
+ *
+ * - Unchanged: loaded completely before, with the same size and modification time.
+ * - Touched: loaded completely before with the same content, but a new modification time.
+ * - Changed: changed since, or never loaded completely; its rows are replaced.
+ * - New: not in the manifest yet.
+ */
+enum class SourceStatus {
+    Unchanged,
+    Touched,
+    Changed,
+    New,
+};
+
+/**
+ * @struct ParsedFile
+ * @brief A chunk of parsed rows of one input file, handed from the parser to the writer stage.
+ *
+ * A file is delivered as one or more chunks of at most `LoadOptions::chunkRows` measurements;
+ * `complete` is set on the last chunk of the file. Every chunk carries the file's manifest
+ * entry in `source`, the last one with its content hash. `lines` counts the lines read for the
+ * chunk, and `rejects` holds those of its rows that were kept out of the measurements. The
+ * measurements are kept column-wise in a `MeasurementBatch`, which costs a fraction of the
+ * memory of `Measurement` objects.
+ *
+ * A chunk with `record` set carries no rows; it asks the writer to record `source` in the
+ * manifest with that status, ahead of the file's rows, so only the writer changes the database.
+ */
+struct ParsedFile {
+    MeasurementBatch measurements;
+    std::vector<Station> stations;
+    ParseErrors errors;
+    std::vector<RejectedRow> rejects;
+    size_t lines = 0;
+    bool complete = false;
+    ManifestEntry source;
+    std::optional<SourceStatus> record;
 };
 
 /**
@@ -24,30 +105,61 @@ struct LoadOptions {
  *
  * The WeatherHandler class is responsible for managing weather data, including loading files,
  * batch processing, and saving data into a SQLite database. Additionally, it provides asynchronous
- * and batch-loading functionality along with progress tracking.
+ * and batch-loading functionality along with progress tracking. Mapped files of at least
+ * `splitThreshold` bytes are split into ranges of about `splitSize` bytes that are parsed in
+ * parallel, so a single huge file does not leave all but one thread idle.
  */
 class WeatherHandler {
 public:
+    // Receives an archive member's reader (null if it need not be loaded), entry, status, and
+    // whether the reader streams from the archive and must be consumed during the call
+    using ArchiveConsumer = std::function<void(const std::shared_ptr<FileReader>&, ManifestEntry&, SourceStatus, bool)>;
+
+    static constexpr size_t splitThreshold = 64 * 1024 * 1024;
+    static constexpr size_t splitSize = 4 * 1024 * 1024;
+    static constexpr size_t archiveMemberInMemory = 16 * 1024 * 1024;
+
     WeatherHandler(std::string path, LoadOptions options);
     void load(std::mutex& mutex);
-    void loadBatch(std::mutex& mutex, std::vector<std::filesystem::directory_entry> files);
+    void loadBatch(std::mutex& mutex, std::vector<ManifestEntry> files);
     void loadBatch(std::mutex& mutex);
-    void loadAsync(std::mutex& mutex);
+    void loadAsync();
+    Throughput parseOnly();
+    Throughput replay(size_t rounds);
+    const ParseErrors& getParseErrors() const;
+    const RejectSink& getRejects() const;
+    const IngestMetrics& getMetrics() const;
+    ThreadPool& getPool();
+    bool wasInterrupted() const;
     ~WeatherHandler();
 private:
-    LoadOptions* options;
+    LoadOptions options;
     SQLiteHandler db;
+    ThreadPool pool;
     std::string path;
-    std::vector<std::string> stations;
+    StationRegistry stations;
+    ParseErrors parseErrors;
+    RejectSink rejects;
+    IngestMetrics metrics;
+    std::vector<const SectionDecoder*> sectionDecoders;
     int batchCount = 0;
     int workFiles = 0;
     int workMeasurements = 0;
     int workStations = 0;
     int workBatches = 0;
-    std::vector<std::filesystem::directory_entry> loadFiles() const;
-    void save(std::vector<Measurement> &measurements, std::mutex &mutex);
-    void save(std::vector<Station> &stations, std::mutex &mutex);
-    std::shared_ptr<barkeep::CompositeDisplay> generateBars(int files, int measurements, int stations, int batches);
+    std::vector<ManifestEntry> loadFiles();
+    bool registerSource(const std::map<std::string, ManifestEntry>& manifest, ManifestEntry& source);
+    SourceStatus checkSource(const std::map<std::string, ManifestEntry>& manifest, ManifestEntry& source, const std::function<std::string()>& hash) const;
+    void recordSource(ManifestEntry& source, SourceStatus status);
+    void loadArchive(std::mutex& mutex);
+    void readArchive(const std::map<std::string, ManifestEntry>& manifest, const ArchiveConsumer& consume);
+    void saveFile(FileReader& file, const ManifestEntry& source, std::mutex& mutex);
+    void parseFile(FileReader& file, const ManifestEntry& source, const std::function<void(ParsedFile&)>& flush, std::string_view header = {});
+    void parseSplit(FileReader& file, const ManifestEntry& source, const std::function<void(ParsedFile&)>& flush);
+    void save(BulkWriter &bulk, MeasurementBatch &measurements, std::mutex &mutex);
+    void save(BulkWriter &bulk, std::vector<Station> &stations, std::mutex &mutex);
+    void finishMetrics();
+    std::shared_ptr<barkeep::CompositeDisplay> generateBars(int files, int batches);
 };
 
 
@@ -5,6 +5,7 @@
 #include <regex>
 #include <filesystem>
 #include <future>
+#include <sstream>
 
 #include "Measurement.h"
 #include "Station.h"
@@ -43,15 +44,36 @@ void helpCommand(const std::map<std::string, Command>& commands) {
     }
 }
 
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
 void loadCommand(const std::vector<std::string>& options) {
     bool drop = false;
     bool async = false;
     bool batch = false;
     bool clean = false;
     bool garbage = false;
+    bool append = false;
+    bool parseOnly = false;
+    size_t replay = 0;
     int limit = 0;
     int batchSize = 100;
+    size_t threads = 0;
+    size_t chunkRows = 10000;
+    size_t commitRows = 0;
     std::string path;
+    std::string rejects = "rejects.csv";
+    std::string metrics;
+    std::vector<std::string> sections;
 
     for (size_t i = 0; i < options.size(); ++i) {
         if (options[i] == "--drop") {
@@ -60,6 +82,21 @@ void loadCommand(const std::vector<std::string>& options) {
             async = true;
         } else if (options[i] == "--batch") {
             batch = true;
+        } else if (options[i] == "--append") {
+            append = true;
+        } else if (options[i] == "--resume") {
+            // Completed files are skipped and incomplete ones reloaded, exactly as for --append
+            append = true;
+        } else if (options[i] == "--parse-only") {
+            parseOnly = true;
+        } else if (options[i] == "--replay") {
+            if (i + 1 < options.size()) {
+                replay = std::stoul(options[i + 1]);
+                ++i;
+            } else {
+                std::cerr << "Error: --replay option requires a value." << std::endl;
+                return;
+            }
         } else if (options[i] == "--limit") {
             if (i + 1 < options.size()) {
                 limit = std::stoi(options[i + 1]);
@@ -76,6 +113,54 @@ void loadCommand(const std::vector<std::string>& options) {
                 std::cerr << "Error: --batch-size option requires a value." << std::endl;
                 return;
             }
+        } else if (options[i] == "--threads") {
+            if (i + 1 < options.size()) {
+                threads = std::stoul(options[i + 1]);
+                ++i;
+            } else {
+                std::cerr << "Error: --threads option requires a value." << std::endl;
+                return;
+            }
+        } else if (options[i] == "--chunk-rows") {
+            if (i + 1 < options.size()) {
+                chunkRows = std::stoul(options[i + 1]);
+                ++i;
+            } else {
+                std::cerr << "Error: --chunk-rows option requires a value." << std::endl;
+                return;
+            }
+        } else if (options[i] == "--commit-rows") {
+            if (i + 1 < options.size()) {
+                commitRows = std::stoul(options[i + 1]);
+                ++i;
+            } else {
+                std::cerr << "Error: --commit-rows option requires a value." << std::endl;
+                return;
+            }
+        } else if (options[i] == "--sections") {
+            if (i + 1 < options.size()) {
+                sections = splitList(options[i + 1]);
+                ++i;
+            } else {
+                std::cerr << "Error: --sections option requires a value." << std::endl;
+                return;
+            }
+        } else if (options[i] == "--rejects") {
+            if (i + 1 < options.size()) {
+                rejects = options[i + 1];
+                ++i;
+            } else {
+                std::cerr << "Error: --rejects option requires a value." << std::endl;
+                return;
+            }
+        } else if (options[i] == "--metrics") {
+            if (i + 1 < options.size()) {
+                metrics = options[i + 1];
+                ++i;
+            } else {
+                std::cerr << "Error: --metrics option requires a value." << std::endl;
+                return;
+            }
         } else if (options[i] == "--clean") {
             clean = true;
         } else if (options[i] == "--garbage") {
@@ -96,6 +181,15 @@ void loadCommand(const std::vector<std::string>& options) {
 
     if (path.empty()) {
         std::cerr << "Error: --path option is required." << std::endl;
+        return;
+    }
+    if (parseOnly && replay > 0) {
+        std::cerr << "Error: --parse-only and --replay options are mutually exclusive." << std::endl;
+        return;
+    }
+    if (async && batch) {
+        std::cerr << "Error: --async and --batch options are mutually exclusive." << std::endl;
+        return;
     }
 
     std::cout << "Loading data from " << path << std::endl;
@@ -108,25 +202,52 @@ void loadCommand(const std::vector<std::string>& options) {
         .batchSize = batchSize,
         .async = async,
         .batch = batch,
+        .sections = sections,
+        .threads = threads,
+        .chunkRows = chunkRows,
+        .append = append,
+        .commitRows = commitRows,
+        .rejects = rejects,
+        .metrics = metrics,
+        .parseOnly = parseOnly,
+        .replay = replay > 0,
     });
 
+    if (parseOnly) {
+        const Throughput parsed = weatherHandler.parseOnly();
+        const double megabytes = static_cast<double>(parsed.bytes) / (1024 * 1024);
+        std::cout << "Parsed " << parsed.rows << " rows (" << megabytes << " MB) in " << parsed.seconds * 1000 << "ms: "
+                  << IngestMetrics::perSecond(static_cast<double>(parsed.rows), parsed.seconds) << " rows/s, "
+                  << IngestMetrics::perSecond(megabytes, parsed.seconds) << " MB/s" << std::endl;
+        weatherHandler.getParseErrors().print(std::cerr);
+        weatherHandler.getRejects().print(std::cerr);
+        return;
+    }
+    if (replay > 0) {
+        const Throughput replayed = weatherHandler.replay(replay);
+        std::cout << "Replayed " << replayed.rows << " rows in " << replayed.seconds * 1000 << "ms: "
+                  << IngestMetrics::perSecond(static_cast<double>(replayed.rows), replayed.seconds) << " inserts/s" << std::endl;
+        return;
+    }
+
     auto t1 = std::chrono::high_resolution_clock::now();
 
-    if (async && batch) {
-        std::cerr << "Error: --async and --batch options are mutually exclusive." << std::endl;
+    if (async) {
+        weatherHandler.loadAsync();
+    } else if (batch) {
+        weatherHandler.loadBatch(mtx);
     }else {
-        if (async) {
-            weatherHandler.loadAsync(mtx);
-        } else if (batch) {
-            weatherHandler.loadBatch(mtx);
-        }else {
-            weatherHandler.load(mtx);
-        }
+        weatherHandler.load(mtx);
     }
 
     auto t2 = std::chrono::high_resolution_clock::now();
 
     std::cout << "Finished loading data in " << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << "ms" << std::endl;
+    if (weatherHandler.wasInterrupted()) {
+        std::cerr << "Warning: Load interrupted. Files in flight were committed; run load with --resume to continue." << std::endl;
+    }
+    weatherHandler.getParseErrors().print(std::cerr);
+    weatherHandler.getRejects().print(std::cerr);
 
     SQLiteHandler db("weather.db");
 
@@ -135,6 +256,37 @@ void loadCommand(const std::vector<std::string>& options) {
 
 }
 
+void backfillCommand(const std::vector<std::string>& options) {
+    std::vector<std::string> sections;
+
+    for (size_t i = 0; i < options.size(); ++i) {
+        if (options[i] == "--sections") {
+            if (i + 1 < options.size()) {
+                sections = splitList(options[i + 1]);
+                ++i;
+            } else {
+                std::cerr << "Error: --sections option requires a value." << std::endl;
+                return;
+            }
+        } else {
+            std::cerr << "Warning: Unknown option '" << options[i] << "' ignored." << std::endl;
+        }
+    }
+
+    if (sections.empty()) {
+        std::cerr << "Error: --sections option is required." << std::endl;
+        return;
+    }
+
+    SQLiteHandler db("weather.db");
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    int updated = db.backfillSections(AdditionalSections::select(sections));
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Backfilled " << updated << " measurements in " << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << "ms" << std::endl;
+}
+
 void queryCommand(const std::vector<std::string>& options) {
     bool bar = false;
     std::string query;
@@ -184,7 +336,8 @@ int main(int argc, char *argv[]) {
     SetConsoleOutputCP(CP_UTF8);
 
     std::map<std::string, Command> commands = {
-        {"load", {"Load data from directory", {}, {"-d (drop)", "-a (async)", "-c (clean)", "-b (batch)", "-g (garbage)" , "-p (path)", "-bs (batch-size)"}}},
+        {"load", {"Load data from a directory or a tar archive (.tar, .tar.gz, .tar.zst)", {}, {"-d (drop)", "-a (async)", "-c (clean)", "-b (batch)", "-g (garbage)" , "-p (path)", "-bs (batch-size)", "--sections (optional sections to decode, e.g. AA,GA or all)", "--threads (worker threads, default: hardware threads)", "--chunk-rows (rows parsed per database flush, 0 = whole file)", "--commit-rows (rows per database transaction, 0 = one per file)", "--append (load only new or changed files)", "--resume (continue an interrupted load)", "--rejects (CSV file for rows that cannot be stored, default: rejects.csv)", "--metrics (JSON file to write the stage timings of the load to, default: none)", "--parse-only (parse and discard the rows, reporting rows/s and MB/s)", "--replay (write the first parsed chunk this many times to a scratch database, reporting inserts/s)"}}},
+        {"backfill", {"Decode optional sections of loaded measurements", {}, {"--sections (sections to decode, e.g. AA,GA or all)"}}},
         {"query", {"Allows the user to query the weather data", {}, {
         "-t (total)","-s (sort)", "-q (query)",}}},
         {"help", {"Displays the help information", {}, {}}}
@@ -206,6 +359,8 @@ int main(int argc, char *argv[]) {
         helpCommand(commands);
     } else if (command == "load") {
         loadCommand(options);
+    } else if (command == "backfill") {
+        backfillCommand(options);
     } else if (command == "query") {
         queryCommand(options);
     }
@@ -1,6 +1,27 @@
 ﻿#include <catch2/catch_test_macros.hpp>
 
+#include <chrono>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AdditionalSections.h"
+#include "BulkWriter.h"
+#include "ColumnPlan.h"
+#include "CsvScanner.h"
+#include "CsvTokenizer.h"
+#include "FileSplitter.h"
+#include "IsdDecoder.h"
+#include "SQLiteHandler.h"
+#include "TarArchive.h"
+#include "Timestamp.h"
 
 uint32_t factorial( uint32_t number ) {
     return number <= 1 ? number : factorial(number-1) * number;
@@ -11,4 +32,643 @@ TEST_CASE( "Factorials are computed", "[factorial]" ) {
     REQUIRE( factorial( 2) == 2 );
     REQUIRE( factorial( 3) == 6 );
     REQUIRE( factorial(10) == 3'628'800 );
-}
\ No newline at end of file
+}
+
+namespace {
+
+std::vector<std::string_view> tokenize(std::string_view line) {
+    std::vector<std::string_view> fields;
+    CsvTokenizer::tokenize(line, fields);
+    return fields;
+}
+
+std::vector<std::string_view> tokenizeScalar(std::string_view line) {
+    std::vector<std::string_view> fields;
+    CsvTokenizer::tokenizeScalar(line, fields);
+    return fields;
+}
+
+}
+
+TEST_CASE("CSV lines are split into fields", "[tokenizer]") {
+    REQUIRE(tokenize("") == std::vector<std::string_view>{""});
+    REQUIRE(tokenize("a,b,c") == std::vector<std::string_view>{"a", "b", "c"});
+    REQUIRE(tokenize("a,,c,") == std::vector<std::string_view>{"a", "", "c", ""});
+    REQUIRE(tokenize("\"a,b\",c\r") == std::vector<std::string_view>{"a,b", "c"});
+    REQUIRE(tokenize("\"say \"\"hi\"\", ok\",x") == std::vector<std::string_view>{"say \"\"hi\"\", ok", "x"});
+}
+
+TEST_CASE("The vectorized tokenizer agrees with the scalar one", "[tokenizer]") {
+    const std::vector<std::string> lines = {
+        "",
+        ",",
+        "\"\"",
+        "\"72503014732\",\"2023-01-01T00:51:00\",\"7\",\"40.77945\",\"-73.88\",\"3.4\",\"LAGUARDIA AIRPORT, NY US\"",
+        "\"a \"\"quoted\"\" word, and a comma\",b,\"\",c\r",
+        std::string(63, 'x') + ",y",
+        std::string(64, 'x') + ",y",
+        std::string(127, 'x') + ",\"a,b\"",
+        // A quoted field that spans two and then three 64-byte blocks
+        std::string(60, 'x') + ",\"" + std::string(10, ',') + "\",z",
+        "a,\"" + std::string(150, ',') + "\",b,c",
+        // An unterminated quote runs to the end of the line
+        "a,\"b,c" + std::string(100, ','),
+    };
+    for (const std::string& line : lines) {
+        CAPTURE(line);
+        CHECK(tokenize(line) == tokenizeScalar(line));
+    }
+
+    // A quoted comma and an escaped quote at every position of the first three blocks
+    for (size_t offset = 0; offset < 3 * CsvScanner::blockSize; ++offset) {
+        const std::string line = std::string(offset, 'x') + ",\"a,\"\"b\"\",c\"," + std::string(offset % 7, 'y');
+        CAPTURE(line);
+        CHECK(tokenize(line) == tokenizeScalar(line));
+    }
+}
+
+TEST_CASE("The CSV scanner agrees with its scalar reference", "[tokenizer]") {
+    INFO(CsvScanner::isa());
+    for (size_t position = 0; position < CsvScanner::blockSize; ++position) {
+        std::string block(CsvScanner::blockSize, 'x');
+        block[position] = '"';
+        block[(position * 7 + 3) % CsvScanner::blockSize] = ',';
+        const CsvMasks masks = CsvScanner::scan(block.data());
+        const CsvMasks expected = CsvScanner::scanScalar(block.data());
+        CHECK(masks.quotes == expected.quotes);
+        CHECK(masks.commas == expected.commas);
+    }
+}
+
+TEST_CASE("CSV tokenizer throughput", "[tokenizer][.benchmark]") {
+    std::string line;
+    while (line.size() < 4096) {
+        line += "\"72503014732\",\"2023-01-01T00:51:00\",\"FM-15\",\"LAGUARDIA AIRPORT, NY US\",";
+    }
+
+    constexpr size_t rounds = 100000;
+    const auto measure = [&](void (*tokenizer)(std::string_view, std::vector<std::string_view>&)) {
+        std::vector<std::string_view> fields;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < rounds; ++round) {
+            tokenizer(line, fields);
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(line.size() * rounds) / elapsed.count() / 1e9;
+    };
+
+    std::cout << "tokenize (" << CsvScanner::isa() << "): " << measure(CsvTokenizer::tokenize) << " GB/s\n"
+              << "tokenizeScalar: " << measure(CsvTokenizer::tokenizeScalar) << " GB/s" << std::endl;
+}
+
+TEST_CASE("Mandatory ISD sections keep NOAA's fixed-point scale", "[isd]") {
+    ParseErrors errors;
+
+    IsdWind wind{};
+    IsdDecoder::decodeWind("180,1,N,0050,1", wind, errors);
+    CHECK(wind.direction == 180);
+    CHECK(wind.directionQuality == '1');
+    CHECK(wind.type == 'N');
+    CHECK(wind.speed == 50);
+    CHECK(wind.speedQuality == '1');
+
+    IsdReading temperature{};
+    IsdDecoder::decodeTemperature("-0015,1", temperature, CsvField::Temperature, errors);
+    CHECK(temperature.value == -15);
+    CHECK(temperature.quality == '1');
+    IsdDecoder::decodeTemperature("+0231,5", temperature, CsvField::Temperature, errors);
+    CHECK(temperature.value == 231);
+
+    IsdReading pressure{};
+    IsdDecoder::decodePressure("10132,1", pressure, errors);
+    CHECK(pressure.value == 10132);
+
+    CHECK(errors.total() == 0);
+}
+
+TEST_CASE("ISD missing sentinels decode as missing", "[isd]") {
+    ParseErrors errors;
+
+    IsdWind wind{};
+    IsdDecoder::decodeWind("999,9,C,0000,1", wind, errors);
+    CHECK(wind.direction == isdMissing);
+    CHECK(wind.speed == 0);
+    IsdDecoder::decodeWind("999,9,9,9999,9", wind, errors);
+    CHECK(wind.speed == isdMissing);
+
+    IsdCeiling ceiling{};
+    IsdDecoder::decodeCeiling("99999,9,9,N", ceiling, errors);
+    CHECK(ceiling.height == isdMissing);
+    CHECK(ceiling.cavok == 'N');
+
+    IsdVisibility visibility{};
+    IsdDecoder::decodeVisibility("999999,9,9,9", visibility, errors);
+    CHECK(visibility.distance == isdMissing);
+
+    IsdReading temperature{};
+    IsdDecoder::decodeTemperature("+9999,9", temperature, CsvField::DewPoints, errors);
+    CHECK(temperature.value == isdMissing);
+
+    IsdReading pressure{};
+    IsdDecoder::decodePressure("99999,9", pressure, errors);
+    CHECK(pressure.value == isdMissing);
+
+    CHECK(errors.total() == 0);
+}
+
+TEST_CASE("Malformed ISD sections are counted and read as missing", "[isd]") {
+    ParseErrors errors;
+
+    IsdWind wind{};
+    IsdDecoder::decodeWind("180,1,N,0050,1", wind, errors);
+    IsdDecoder::decodeWind("18x,1,N,0050,1", wind, errors);
+    CHECK(wind.direction == isdMissing);
+    CHECK(wind.speed == 50);
+
+    IsdReading temperature{};
+    IsdDecoder::decodeTemperature("-0015", temperature, CsvField::Temperature, errors);
+    CHECK(temperature.value == -15);
+    CHECK(temperature.quality == '\0');
+
+    IsdReading pressure{};
+    pressure.value = 10132;
+    IsdDecoder::decodePressure("", pressure, errors);
+    CHECK(pressure.value == isdMissing);
+
+    CHECK(errors.total() == 3);
+}
+
+TEST_CASE("Additional sections keep their scale and skip missing sentinels", "[sections]") {
+    const std::vector<const SectionDecoder*> enabled = AdditionalSections::select({"AA", "GA", "KB"});
+    REQUIRE(enabled.size() == 3);
+
+    Measurement measurement{};
+    AdditionalSections::decode("AA1\t01,0005,9,1\tAA2\t06,9999,9,9\tGA1\t07,1,+00900,1,06,1\tKB1\t024,A,-0153,1\tKB2\t024,N,+0231,1\tKB3\t024,M,9999,9\tKA1\t010,M,+0250,1", enabled, measurement);
+
+    // KB temperatures are stored in hundredths of a degree, AA depths in tenths of a millimetre
+    CHECK(measurement.temperatureObservations == std::vector<double>{-1.53, 2.31});
+    CHECK(measurement.hourlyPrecipitation == std::vector<double>{0.5});
+    CHECK(measurement.skyCover == std::vector<std::string>{"07,1,+00900,1,06,1"});
+    // KA is not enabled, so it stays raw
+    CHECK(measurement.temperatureExtremes.empty());
+
+    const SectionDecoder* kb = AdditionalSections::decoderFor("KB2", enabled);
+    REQUIRE(kb != nullptr);
+    CHECK(std::string_view(kb->column) == "temperatureObservations");
+    CHECK(kb->serialize(measurement) == "-1.53,2.31");
+
+    Measurement missing{};
+    AdditionalSections::decode("AA1\t01,9999,9,9\tKB1\t024,A,9999,9", enabled, missing);
+    CHECK(missing.hourlyPrecipitation.empty());
+    CHECK(missing.temperatureObservations.empty());
+    CHECK(kb->serialize(missing).empty());
+}
+
+namespace {
+
+/**
+ * @brief Builds a tar archive entry by entry, in the layouts GNU tar and pax writers produce.
+ */
+class TarBuilder {
+public:
+    void add(std::string_view name, std::string_view contents, char type = '0', std::string_view prefix = {}, bool base256 = false) {
+        char header[TarArchive::blockSize] = {};
+        std::memcpy(header, name.data(), std::min<size_t>(name.size(), 100));
+        std::snprintf(header + 100, 8, "%07o", 0644);
+        if (base256) {
+            header[124] = static_cast<char>(0x80);
+            for (size_t i = 0; i < 8; ++i) {
+                header[135 - i] = static_cast<char>((contents.size() >> (8 * i)) & 0xFF);
+            }
+        } else {
+            std::snprintf(header + 124, 12, "%011zo", contents.size());
+        }
+        std::snprintf(header + 136, 12, "%011o", 1700000000u);
+        header[156] = type;
+        std::memcpy(header + 257, "ustar", 6);
+        std::memcpy(header + 263, "00", 2);
+        std::memcpy(header + 345, prefix.data(), std::min<size_t>(prefix.size(), 155));
+
+        std::memset(header + 148, ' ', 8);
+        unsigned sum = 0;
+        for (const char c : header) {
+            sum += static_cast<unsigned char>(c);
+        }
+        std::snprintf(header + 148, 8, "%06o", sum);
+
+        this->bytes.append(header, sizeof(header));
+        this->bytes.append(contents);
+        this->bytes.append((TarArchive::blockSize - contents.size() % TarArchive::blockSize) % TarArchive::blockSize, '\0');
+    }
+
+    std::filesystem::path write(const std::string& fileName) const {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / fileName;
+        std::ofstream out(path, std::ios::binary);
+        out << this->bytes << std::string(2 * TarArchive::blockSize, '\0');
+        return path;
+    }
+private:
+    std::string bytes;
+};
+
+}
+
+TEST_CASE("Tar members are found with their full names", "[tar]") {
+    const std::string longName = "global-hourly/" + std::string(120, 'n') + ".csv";
+    const std::string paxName = "pax/" + std::string(110, 'p') + ".csv";
+    const std::string paxRecord = " path=" + paxName + "\n";
+    const std::string paxRecords = std::to_string(paxRecord.size() + 3) + paxRecord;
+
+    TarBuilder builder;
+    builder.add("2023/", "", '5');
+    builder.add("72503014732.csv", "ustar", '0', "global-hourly/2023");
+    builder.add("././@LongLink", longName + '\0', 'L');
+    builder.add(longName.substr(0, 100), "gnu");
+    builder.add("PaxHeaders/x", paxRecords, 'x');
+    builder.add(paxName.substr(0, 100), "pax");
+    builder.add("base256.csv", "base-256", '0', {}, true);
+    const std::filesystem::path path = builder.write("weather_cli-test-names.tar");
+
+    std::vector<std::pair<std::string, std::string>> members;
+    {
+        TarArchive archive(path);
+        REQUIRE(archive.isOpen());
+        TarMember member;
+        while (archive.next(member)) {
+            std::vector<char> contents;
+            REQUIRE(archive.read(contents));
+            CHECK(member.size == contents.size());
+            CHECK(member.mtime == 1700000000);
+            members.emplace_back(member.name, std::string(contents.begin(), contents.end()));
+        }
+    }
+    std::filesystem::remove(path);
+
+    const std::vector<std::pair<std::string, std::string>> expected = {
+        {"global-hourly/2023/72503014732.csv", "ustar"},
+        {longName, "gnu"},
+        {paxName, "pax"},
+        {"base256.csv", "base-256"},
+    };
+    CHECK(members == expected);
+}
+
+TEST_CASE("Tar members are streamed in pieces and skipped when not read", "[tar]") {
+    std::string large;
+    for (size_t i = 0; large.size() < 1000; ++i) {
+        large += std::to_string(i) + '\n';
+    }
+
+    TarBuilder builder;
+    builder.add("skipped.csv", std::string(700, 's'));
+    builder.add("streamed.csv", large);
+    builder.add("last.csv", "last");
+    const std::filesystem::path path = builder.write("weather_cli-test-stream.tar");
+
+    {
+        TarArchive archive(path);
+        TarMember member;
+        REQUIRE(archive.next(member));
+        CHECK(member.name == "skipped.csv");
+
+        REQUIRE(archive.next(member));
+        CHECK(member.name == "streamed.csv");
+        std::string streamed;
+        char piece[300];
+        size_t read = 0;
+        while ((read = archive.readSome(piece, sizeof(piece))) > 0) {
+            CHECK(read <= sizeof(piece));
+            streamed.append(piece, read);
+        }
+        CHECK(streamed == large);
+
+        REQUIRE(archive.next(member));
+        CHECK(member.name == "last.csv");
+        CHECK_FALSE(archive.next(member));
+    }
+    std::filesystem::remove(path);
+}
+
+namespace {
+
+/**
+ * @brief Checks that ranges cover the contents in order and each one ends outside quotes.
+ */
+void checkRanges(std::string_view contents, const std::vector<std::string_view>& ranges) {
+    std::string joined;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        joined += ranges[i];
+        CHECK_FALSE(FileSplitter::oddQuotes(joined));
+        if (i + 1 < ranges.size()) {
+            CHECK(ranges[i].ends_with('\n'));
+        }
+    }
+    CHECK(joined == contents);
+}
+
+}
+
+TEST_CASE("Files are split on lines that end outside quotes", "[splitter]") {
+    ThreadPool pool(2);
+
+    std::string contents;
+    for (int line = 0; line < 40; ++line) {
+        contents += "\"7250301473" + std::to_string(line % 10) + "\",\"REM line\n" + std::to_string(line) + " continues\nhere\"\n";
+    }
+    for (const size_t rangeSize : {8, 16, 37, 64, 100, 4096}) {
+        CAPTURE(rangeSize);
+        const std::vector<std::string_view> ranges = FileSplitter::split(contents, rangeSize, pool);
+        checkRanges(contents, ranges);
+        for (const std::string_view range : ranges) {
+            CHECK(range.starts_with("\"7250301473"));
+        }
+    }
+}
+
+TEST_CASE("A quoted field longer than a range stays in one range", "[splitter]") {
+    ThreadPool pool(2);
+
+    const std::string quoted = "a,\"" + std::string(100, '\n') + "\"\n";
+    const std::string contents = "h\n" + quoted + "b,c\n";
+    const std::vector<std::string_view> ranges = FileSplitter::split(contents, 16, pool);
+    checkRanges(contents, ranges);
+    REQUIRE(ranges.size() == 2);
+    CHECK(ranges[0] == "h\n" + quoted);
+    CHECK(ranges[1] == "b,c\n");
+
+    CHECK(FileSplitter::split("", 16, pool) == std::vector<std::string_view>{""});
+    CHECK(FileSplitter::split("no newline", 4, pool) == std::vector<std::string_view>{"no newline"});
+}
+
+TEST_CASE("Quote parity is counted across scanner blocks", "[splitter]") {
+    CHECK_FALSE(FileSplitter::oddQuotes(""));
+    CHECK(FileSplitter::oddQuotes("\""));
+    CHECK_FALSE(FileSplitter::oddQuotes(std::string(64, '"')));
+    CHECK(FileSplitter::oddQuotes(std::string(64, '"') + std::string(63, 'x') + '"'));
+    CHECK(FileSplitter::oddQuotes(std::string(129, '"')));
+}
+
+TEST_CASE("ISO times round-trip through epoch seconds", "[timestamp]") {
+    const std::vector<std::pair<std::string_view, int64_t>> times = {
+        {"1970-01-01T00:00:00", 0},
+        {"1969-12-31T23:59:59", -1},
+        {"1901-01-01T00:00:00", -2177452800},
+        {"2000-02-29T12:30:15", 951827415},
+        {"2023-01-01T00:51:00", 1672534260},
+        {"2024-12-31T23:59:59", 1735689599},
+    };
+    for (const auto& [text, seconds] : times) {
+        CAPTURE(text);
+        int64_t value = 0;
+        REQUIRE(Timestamp::parseIso(text, value) == ParseResult::Ok);
+        CHECK(value == seconds);
+        CHECK(Timestamp::formatIso(value) == text);
+    }
+
+    // Every day of a leap and a common year
+    for (const int64_t start : {int64_t{1704067200}, int64_t{1672531200}}) {
+        for (int64_t day = 0; day < 366; ++day) {
+            const std::string text = Timestamp::formatIso(start + day * 86400 + 3723);
+            int64_t value = 0;
+            CAPTURE(text);
+            REQUIRE(Timestamp::parseIso(text, value) == ParseResult::Ok);
+            CHECK(value == start + day * 86400 + 3723);
+        }
+    }
+
+    CHECK(Timestamp::formatIso(timestampMissing).empty());
+}
+
+TEST_CASE("Invalid ISO times are rejected", "[timestamp]") {
+    int64_t value = 42;
+    CHECK(Timestamp::parseIso("", value) == ParseResult::Empty);
+    for (const std::string_view text : {
+             "2023-01-01 00:51:00",
+             "2023-01-01T00:51",
+             "2023-01-01T00:51:00Z",
+             "2023-1-01T00:51:00a",
+             "2023-00-10T00:00:00",
+             "2023-13-01T00:00:00",
+             "2023-01-00T00:00:00",
+             "2023-01-32T00:00:00",
+             "2023-02-29T00:00:00",
+             "1900-02-29T00:00:00",
+             "2023-04-31T00:00:00",
+             "2023-01-01T24:00:00",
+             "2023-01-01T00:60:00",
+             "2023-01-01T00:00:60",
+         }) {
+        CAPTURE(text);
+        CHECK(Timestamp::parseIso(text, value) == ParseResult::Invalid);
+    }
+    CHECK(value == 42);
+}
+
+TEST_CASE("A header in NOAA's layout resolves to the standard plan", "[columns]") {
+    const std::string header = "\"STATION\",\"DATE\",\"SOURCE\",\"LATITUDE\",\"LONGITUDE\",\"ELEVATION\",\"NAME\","
+        "\"REPORT_TYPE\",\"CALL_SIGN\",\"QUALITY_CONTROL\",\"WND\",\"CIG\",\"VIS\",\"TMP\",\"DEW\",\"SLP\",\"AA1\",\"GA1\",\"EQD\"\r";
+    REQUIRE(ColumnPlan::isHeader(header));
+
+    const ColumnPlan plan = ColumnPlan::fromHeader(header, AdditionalSections::select({"AA"}));
+    const ColumnPlan standard;
+    CHECK(plan.columns == standard.columns);
+    CHECK(plan.width == standard.width);
+
+    REQUIRE(plan.sections.size() == 3);
+    CHECK(plan.sections[0].index == 16);
+    CHECK(plan.sections[0].code == "AA1");
+    REQUIRE(plan.sections[0].decoder != nullptr);
+    CHECK(std::string_view(plan.sections[0].decoder->prefix) == "AA");
+    CHECK(plan.sections[1].code == "GA1");
+    CHECK(plan.sections[1].decoder == nullptr);
+    CHECK(plan.sections[2].code == "EQD");
+}
+
+TEST_CASE("Headers with a byte order mark, reordered or missing columns are resolved", "[columns]") {
+    const std::string header = "\xEF\xBB\xBF" "DATE,STATION,TMP,REM,NAME";
+    REQUIRE(ColumnPlan::isHeader("\xEF\xBB\xBF" "STATION,DATE"));
+    CHECK_FALSE(ColumnPlan::isHeader("\"72503014732\",\"2023-01-01T00:51:00\""));
+
+    const ColumnPlan plan = ColumnPlan::fromHeader(header, {});
+    CHECK(plan.columns[static_cast<size_t>(CsvColumn::Date)] == 0);
+    CHECK(plan.columns[static_cast<size_t>(CsvColumn::Station)] == 1);
+    CHECK(plan.columns[static_cast<size_t>(CsvColumn::Temperature)] == 2);
+    CHECK(plan.columns[static_cast<size_t>(CsvColumn::Name)] == 4);
+    CHECK(plan.columns[static_cast<size_t>(CsvColumn::Wind)] == ColumnPlan::absent);
+    CHECK(plan.width == 5);
+    REQUIRE(plan.sections.size() == 1);
+    CHECK(plan.sections[0].index == 3);
+    CHECK(plan.sections[0].code == "REM");
+
+    std::vector<std::string_view> fields;
+    CsvTokenizer::tokenize("2023-01-01T00:51:00,72503014732,\"+0015,1\",REM text,LAGUARDIA", fields);
+    REQUIRE(fields.size() == plan.width);
+    CHECK(plan.field(fields, CsvColumn::Station) == "72503014732");
+    CHECK(plan.field(fields, CsvColumn::Date) == "2023-01-01T00:51:00");
+    CHECK(plan.field(fields, CsvColumn::Temperature) == "+0015,1");
+    CHECK(fields[plan.sections[0].index] == "REM text");
+    CHECK(plan.field(fields, CsvColumn::Name) == "LAGUARDIA");
+    CHECK(plan.field(fields, CsvColumn::Wind).empty());
+
+    // Only the first occurrence of a repeated column is read
+    const ColumnPlan repeated = ColumnPlan::fromHeader("STATION,DATE,STATION", {});
+    CHECK(repeated.columns[static_cast<size_t>(CsvColumn::Station)] == 0);
+}
+
+namespace {
+
+/**
+ * @brief Returns the path of a database file in the temporary directory, removing an old one.
+ */
+std::filesystem::path temporaryDatabase(const std::string& fileName) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / fileName;
+    std::filesystem::remove(path);
+    return path;
+}
+
+/**
+ * @brief Parses CSV rows with the columns STATION, DATE, SOURCE, REPORT_TYPE and
+ *        QUALITY_CONTROL into a batch, encoding them with the handler's dictionaries.
+ */
+MeasurementBatch parseRows(SQLiteHandler& db, const std::vector<std::string>& lines) {
+    const ColumnPlan plan = ColumnPlan::fromHeader("STATION,DATE,SOURCE,REPORT_TYPE,QUALITY_CONTROL", {});
+    MeasurementBatch batch;
+    ParseErrors errors;
+    std::vector<std::string_view> fields;
+    for (const std::string& line : lines) {
+        CsvTokenizer::tokenize(line, fields);
+        batch.append(fields, plan, db.getDictionaries(), 0, errors);
+    }
+    REQUIRE(batch.size() == lines.size());
+    return batch;
+}
+
+}
+
+TEST_CASE("Dictionary codes keep their ids when stored and loaded again", "[database]") {
+    const std::filesystem::path path = temporaryDatabase("weather-cli-dictionaries.db");
+    int32_t source = 0;
+    int32_t reportType = 0;
+    int32_t synoptic = 0;
+    int32_t flag = 0;
+    {
+        SQLiteHandler db(path.string());
+        db.init();
+        MeasurementDictionaries& dictionaries = db.getDictionaries();
+        source = dictionaries.source.encode("4");
+        reportType = dictionaries.reportType.encode("FM-15");
+        synoptic = dictionaries.reportType.encode("SY-MT");
+        flag = dictionaries.qualityControlFlag.encode("V020");
+        CHECK(dictionaries.reportType.encode("FM-15") == reportType);
+
+        // Inserting a batch stores the codes assigned since the last insert, even without rows
+        const MeasurementBatch empty{};
+        db.insertMeasurements(empty);
+        // Codes handed over again, as after a rollback, are stored already and ignored
+        dictionaries.reportType.restoreAdded();
+        db.insertMeasurements(empty);
+
+        using Rows = std::vector<std::map<std::string, std::string>>;
+        CHECK(db.executeQuery("SELECT id, value FROM sources ORDER BY id;") == Rows{{{"id", std::to_string(source)}, {"value", "4"}}});
+        CHECK(db.executeQuery("SELECT id, value FROM reportTypes ORDER BY id;") == Rows{
+            {{"id", std::to_string(reportType)}, {"value", "FM-15"}},
+            {{"id", std::to_string(synoptic)}, {"value", "SY-MT"}},
+        });
+        CHECK(db.executeQuery("SELECT id, value FROM qualityControlFlags ORDER BY id;") == Rows{{{"id", std::to_string(flag)}, {"value", "V020"}}});
+    }
+
+    {
+        SQLiteHandler db(path.string());
+        db.init();
+        MeasurementDictionaries& dictionaries = db.getDictionaries();
+        CHECK(dictionaries.source.size() == 1);
+        CHECK(dictionaries.reportType.size() == 2);
+        CHECK(dictionaries.qualityControlFlag.size() == 1);
+        CHECK(dictionaries.source.encode("4") == source);
+        CHECK(dictionaries.reportType.encode("SY-MT") == synoptic);
+        CHECK(dictionaries.reportType.encode("FM-15") == reportType);
+        CHECK(dictionaries.qualityControlFlag.encode("V020") == flag);
+        // Loaded codes are not stored again, and new values continue after them
+        CHECK(dictionaries.reportType.takeAdded().empty());
+        CHECK(dictionaries.reportType.encode("FM-16") == std::max(reportType, synoptic) + 1);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("A bulk writer commits every commitRows rows and rolls back the rest", "[database]") {
+    const std::filesystem::path path = temporaryDatabase("weather-cli-bulk-commit.db");
+    {
+        SQLiteHandler db(path.string());
+        db.init();
+        {
+            BulkWriter bulk(db, 2);
+            bulk.write(parseRows(db, {
+                "72503014732,2023-01-01T00:51:00,4,FM-15,V020",
+                "72503014732,2023-01-01T01:51:00,4,FM-15,V020",
+                "72503014732,2023-01-01T02:51:00,4,FM-15,V020",
+            }));
+            CHECK(bulk.pending() == 1);
+            CHECK(db.countMeasurements() == 3);
+        }
+        // The writer was destroyed without `commit`, discarding the row after the boundary
+        CHECK(db.countMeasurements() == 2);
+
+        BulkWriter bulk(db, 2);
+        bulk.write(parseRows(db, {"72503014732,2023-01-01T03:51:00,4,FM-15,V020"}));
+        bulk.commit();
+        CHECK(bulk.pending() == 0);
+    }
+
+    {
+        SQLiteHandler reopened(path.string());
+        CHECK(reopened.countMeasurements() == 3);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("A failed bulk write leaves neither rows nor dictionary codes behind", "[database]") {
+    const std::filesystem::path path = temporaryDatabase("weather-cli-bulk-rollback.db");
+    using Rows = std::vector<std::map<std::string, std::string>>;
+    {
+        SQLiteHandler db(path.string());
+        db.init();
+        BulkWriter bulk(db, 0);
+        bulk.write(parseRows(db, {"72503014732,2023-01-01T00:51:00,4,FM-15,V020"}));
+        bulk.commit();
+
+        // New codes are stored in the same transaction as the rows using them
+        bulk.write(parseRows(db, {
+            "72503014732,2023-01-01T01:51:00,7,SY-MT,V030",
+            "72503014732,2023-01-01T02:51:00,4,FM-15,V020",
+        }));
+        CHECK(db.countMeasurements() == 3);
+        CHECK(db.executeQuery("SELECT value FROM reportTypes ORDER BY id;").size() == 2);
+
+        // The second station repeats the primary key, failing the transaction in the middle
+        const std::vector<Station> stations = {
+            {"72503014732", "LAGUARDIA AIRPORT, NY US", -73.88, 40.77945, 3.4, "KLGA"},
+            {"72503014732", "LAGUARDIA AIRPORT, NY US", -73.88, 40.77945, 3.4, "KLGA"},
+        };
+        CHECK_THROWS_AS(bulk.write(stations), SQLite::Exception);
+        CHECK(bulk.pending() == 0);
+        CHECK(db.countMeasurements() == 1);
+        CHECK(db.countStations() == 0);
+        CHECK(db.executeQuery("SELECT value FROM reportTypes;") == Rows{{{"value", "FM-15"}}});
+        CHECK(db.executeQuery("SELECT value FROM sources;") == Rows{{{"value", "4"}}});
+        CHECK(db.executeQuery("SELECT value FROM qualityControlFlags;") == Rows{{{"value", "V020"}}});
+
+        // The rolled back codes stay assigned and are stored with the next rows that are written
+        CHECK(db.getDictionaries().reportType.size() == 2);
+        bulk.write(parseRows(db, {"72503014732,2023-01-01T03:51:00,4,FM-15,V020"}));
+        bulk.commit();
+    }
+
+    {
+        SQLiteHandler reopened(path.string());
+        CHECK(reopened.countMeasurements() == 2);
+        CHECK(reopened.executeQuery("SELECT value FROM reportTypes ORDER BY id;") == Rows{{{"value", "FM-15"}}, {{"value", "SY-MT"}}});
+        CHECK(reopened.executeQuery("SELECT value FROM sources ORDER BY id;") == Rows{{{"value", "4"}}, {{"value", "7"}}});
+        CHECK(reopened.executeQuery("SELECT value FROM qualityControlFlags ORDER BY id;") == Rows{{{"value", "V020"}}, {{"value", "V030"}}});
+    }
+    std::filesystem::remove(path);
+}